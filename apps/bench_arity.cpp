@@ -0,0 +1,79 @@
+#include "priority_queue.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Payload types of different sizes.
+struct Small {
+    unsigned x;
+};
+
+struct Line {
+    unsigned x[16];
+};
+
+struct Big {
+    unsigned x[64];
+};
+
+static const unsigned N = 200000;
+
+/**
+ * Times a Dijkstra-like workload: N inserts, 4N decreaseKeys and
+ * N deleteMins on a PriorityQueue with the given arity.
+ * Returns elapsed milliseconds.
+ */
+template <typename ValueType, unsigned Arity>
+static double run(const std::vector<unsigned>& keys, const std::vector<unsigned>& ops)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    PriorityQueue<ValueType, DirectIndexMap<unsigned>, Arity> pq(N);
+    ValueType value{};
+    for(unsigned i = 0; i < N; i++) {
+        pq.insert(i, keys[i], value);
+    }
+    for(unsigned i = 0; i < ops.size(); i++) {
+        const unsigned* key = pq.getKey(ops[i]);
+        if(*key > 16) {
+            pq.decreaseKey(ops[i], 16);
+        }
+    }
+    while(pq.deleteMin()) {
+    }
+
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+template <typename ValueType>
+static void row(const char* name, const std::vector<unsigned>& keys, const std::vector<unsigned>& ops)
+{
+    std::cout << name << '\t' << sizeof(ValueType)
+        << '\t' << run<ValueType, 2>(keys, ops)
+        << '\t' << run<ValueType, 4>(keys, ops)
+        << '\t' << run<ValueType, 8>(keys, ops)
+        << '\t' << run<ValueType, 16>(keys, ops) << '\n';
+}
+
+int main()
+{
+    std::mt19937 rng(42);
+    std::vector<unsigned> keys(N);
+    for(unsigned i = 0; i < N; i++) {
+        keys[i] = rng() % 1000000000;
+    }
+    std::vector<unsigned> ops(4*N);
+    for(unsigned i = 0; i < ops.size(); i++) {
+        ops[i] = rng() % N;
+    }
+
+    std::cout << "payload\tbytes\td=2(ms)\td=4(ms)\td=8(ms)\td=16(ms)\n";
+    row<Small>("Small", keys, ops);
+    row<std::string>("string", keys, ops);
+    row<Line>("Line", keys, ops);
+    row<Big>("Big", keys, ops);
+}
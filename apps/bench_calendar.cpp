@@ -0,0 +1,47 @@
+#include "priority_queue.hpp"
+#include "calendar_queue.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <random>
+
+/**
+ * Times the classic "hold" model of discrete-event simulation on
+ * a PriorityQueue and on a CalendarQueue: the queue holds n
+ * events, and each step removes the earliest one and schedules
+ * it again at its timestamp plus an exponentially distributed
+ * delay. Both use DirectIndexMap so that only the queue differs.
+ * Prints the time per hold step.
+ */
+template <typename Queue>
+static double run(Queue& queue, unsigned n, unsigned steps)
+{
+    std::mt19937 rng(7);
+    std::exponential_distribution<double> delay(1.0 / 1000);
+    for(unsigned id = 0; id < n; id++) {
+        queue.insert(id, static_cast<unsigned>(delay(rng)), id);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for(unsigned i = 0; i < steps; i++) {
+        unsigned id = *queue.getMinId();
+        unsigned now = *queue.getMinKey();
+        queue.deleteMin();
+        queue.insert(id, now + static_cast<unsigned>(delay(rng)), id);
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / steps;
+}
+
+int main()
+{
+    const unsigned steps = 1000000;
+    std::cout << "n\tPriorityQueue(ns/op)\tCalendarQueue(ns/op)\n";
+    for(unsigned n = 1000; n <= 1000000; n *= 10) {
+        PriorityQueue<unsigned, DirectIndexMap<unsigned>> pq;
+        CalendarQueue<unsigned, DirectIndexMap<unsigned>> cq;
+        double heap = run(pq, n, steps);
+        double calendar = run(cq, n, steps);
+        std::cout << n << '\t' << heap << '\t' << calendar << '\n';
+    }
+}
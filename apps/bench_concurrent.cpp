@@ -0,0 +1,89 @@
+#include "priority_queue.hpp"
+#include "multi_queue.hpp"
+#include "skiplist_queue.hpp"
+#include "concurrent_priority_queue.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+/**
+ * Times a mixed workload of concurrent inserts and deleteMins,
+ * half each, on a PriorityQueue behind a single mutex, on a
+ * MultiQueue, on a SkipListQueue and on a ConcurrentPriorityQueue,
+ * with 1 to 64 threads. Each queue starts with
+ * @prefill elements, and totalOps operations are split evenly
+ * among the threads, each on its own ids. Prints throughput in millions of operations per
+ * second; it only scales as far as the machine has cores.
+ */
+static const unsigned prefill = 100000;
+static const unsigned totalOps = 1u << 21;
+
+class LockedQueue
+{
+public:
+    bool insert(unsigned id, unsigned key, unsigned value) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return queue.insert(id, key, value);
+    }
+
+    bool deleteMin(Element<unsigned>& out) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return queue.deleteMinBatch(1, &out) == 1;
+    }
+
+private:
+    std::mutex mutex;
+    PriorityQueue<unsigned> queue;
+};
+
+template <typename Queue>
+static double run(Queue& queue, unsigned threads)
+{
+    std::mt19937 rng(7);
+    for(unsigned id = 0; id < prefill; id++) {
+        queue.insert(id, rng(), id);
+    }
+
+    unsigned opsPerThread = totalOps / threads;
+    auto work = [&queue, opsPerThread](unsigned thread) {
+        std::mt19937 rng(thread);
+        Element<unsigned> out;
+        unsigned id = prefill + thread*opsPerThread;
+        for(unsigned i = 0; i < opsPerThread; i += 2) {
+            queue.insert(id, rng(), id);
+            id++;
+            queue.deleteMin(out);
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for(unsigned t = 0; t < threads; t++) {
+        workers.emplace_back(work, t);
+    }
+    for(unsigned t = 0; t < threads; t++) {
+        workers[t].join();
+    }
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    return threads * static_cast<double>(opsPerThread) / elapsed.count();
+}
+
+int main()
+{
+    std::cout << "threads\tmutex+PriorityQueue(Mops/s)\tMultiQueue(Mops/s)\tSkipListQueue(Mops/s)\tConcurrentPriorityQueue(Mops/s)\n";
+    for(unsigned threads = 1; threads <= 64; threads *= 2) {
+        LockedQueue locked;
+        MultiQueue<unsigned> multi(threads);
+        SkipListQueue<unsigned> skipList;
+        ConcurrentPriorityQueue<unsigned> fineGrained(2*prefill);
+        double lockedRate = run(locked, threads);
+        double multiRate = run(multi, threads);
+        double skipListRate = run(skipList, threads);
+        double fineGrainedRate = run(fineGrained, threads);
+        std::cout << threads << '\t' << lockedRate << '\t' << multiRate << '\t' << skipListRate << '\t' << fineGrainedRate << '\n';
+    }
+}
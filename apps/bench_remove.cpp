@@ -0,0 +1,52 @@
+#include "priority_queue.hpp"
+#include "lazy_priority_queue.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+/**
+ * Times remove() on queues of growing size: fills a queue with n
+ * elements, then removes @rounds (<= n) distinct random ids. With remove()
+ * in O(log n), the time per operation should grow only slowly as
+ * n goes up 10x at a time (mostly from cache misses), rather than
+ * 10x per step.
+ *
+ * The last column is LazyPriorityQueue, whose remove() only marks
+ * the element stale (the occasional compaction is included).
+ */
+template <typename Queue>
+static double run(Queue& pq, unsigned n, unsigned rounds)
+{
+    std::mt19937 rng(7);
+    std::vector<unsigned> ids(n);
+    for(unsigned i = 0; i < n; i++) {
+        pq.insert(i, rng(), i);
+        ids[i] = i;
+    }
+    std::shuffle(ids.begin(), ids.end(), rng);
+
+    auto start = std::chrono::steady_clock::now();
+    for(unsigned i = 0; i < rounds; i++) {
+        pq.remove(ids[i]);
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / rounds;
+}
+
+int main()
+{
+    std::cout << "n\tHashTable(ns/op)\tDirectIndexMap(ns/op)\tLazyPriorityQueue(ns/op)\n";
+    for(unsigned n = 1000; n <= 1000000; n *= 10) {
+        unsigned rounds = std::min(n/2, 50000u);
+        PriorityQueue<unsigned> hashed(n);
+        PriorityQueue<unsigned, DirectIndexMap<unsigned>> direct(n);
+        LazyPriorityQueue<unsigned> lazy;
+        lazy.reserve(n);
+        std::cout << n << '\t' << run(hashed, n, rounds)
+            << '\t' << run(direct, n, rounds)
+            << '\t' << run(lazy, n, rounds) << '\n';
+    }
+}
@@ -0,0 +1,94 @@
+#include "priority_queue.hpp"
+#include "timing_wheel.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <vector>
+
+/**
+ * Times a timeout-style workload on a PriorityQueue keyed by
+ * deadline and on a TimingWheel: every tick schedules @perTick
+ * timers due 1000 to 5000 ticks later, cancels 9 out of 10 of the
+ * timers scheduled 500 ticks earlier, and expires the timers that
+ * are due. Both use DirectIndexMap so that only the timer structure
+ * differs. Prints the time per scheduled timer.
+ */
+static const unsigned ticks = 3000;
+static const unsigned perTick = 1000;
+static const unsigned cancelLag = 500;
+
+static std::vector<unsigned> makeDeadlines()
+{
+    std::mt19937 rng(7);
+    std::vector<unsigned> deadlines(ticks*perTick);
+    for(unsigned i = 0; i < deadlines.size(); i++) {
+        deadlines[i] = i/perTick + 1000 + rng()%4000;
+    }
+    return deadlines;
+}
+
+static double runHeap(const std::vector<unsigned>& deadlines, unsigned& expired)
+{
+    PriorityQueue<unsigned, DirectIndexMap<unsigned>> pq;
+    expired = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for(unsigned t = 0; t < ticks; t++) {
+        for(unsigned id = t*perTick; id < (t+1)*perTick; id++) {
+            pq.insert(id, deadlines[id], id);
+        }
+        if(t >= cancelLag) {
+            for(unsigned id = (t-cancelLag)*perTick; id < (t-cancelLag+1)*perTick; id++) {
+                if(id%10 != 0) {
+                    pq.remove(id);
+                }
+            }
+        }
+        while(pq.numElements() > 0 && *pq.getMinKey() <= t) {
+            pq.deleteMin();
+            expired++;
+        }
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / deadlines.size();
+}
+
+static double runWheel(const std::vector<unsigned>& deadlines, unsigned& expired)
+{
+    TimingWheel<unsigned, DirectIndexMap<unsigned>> wheel;
+    std::vector<Element<unsigned>> due;
+    expired = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for(unsigned t = 0; t < ticks; t++) {
+        for(unsigned id = t*perTick; id < (t+1)*perTick; id++) {
+            wheel.insert(id, deadlines[id], id);
+        }
+        if(t >= cancelLag) {
+            for(unsigned id = (t-cancelLag)*perTick; id < (t-cancelLag+1)*perTick; id++) {
+                if(id%10 != 0) {
+                    wheel.remove(id);
+                }
+            }
+        }
+        due.clear();
+        expired += wheel.advance(t, std::back_inserter(due));
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / deadlines.size();
+}
+
+int main()
+{
+    std::vector<unsigned> deadlines = makeDeadlines();
+    unsigned heapExpired;
+    unsigned wheelExpired;
+    double heap = runHeap(deadlines, heapExpired);
+    double wheel = runWheel(deadlines, wheelExpired);
+
+    std::cout << "structure\tns/timer\texpired\n";
+    std::cout << "PriorityQueue\t" << heap << '\t' << heapExpired << '\n';
+    std::cout << "TimingWheel\t" << wheel << '\t' << wheelExpired << '\n';
+}
@@ -0,0 +1,44 @@
+#include "bucket_queue.hpp"
+
+#include <iostream>
+#include <string>
+
+static void printMin(const BucketQueue<std::string>& bq)
+{
+    std::cout << "Min: " << *(bq.getMinId()) << ' ' << *(bq.getMinKey()) << ' '
+        << *(bq.getMinValue()) << '\n';
+}
+
+int main()
+{
+    std::cout << std::boolalpha;
+
+    // Basic operations; priorities are in [0, 16).
+    BucketQueue<std::string> bq(16);
+    std::cout << bq.insert(1, 10, "AA") << '\n';
+    bq.insert(2, 13, "BB");
+    bq.insert(3, 8, "CC");
+    bq.insert(4, 5, "DD");
+    bq.insert(5, 5, "EE");
+    std::cout << bq.insert(3, 1, "dup") << ' ' << bq.insert(6, 16, "FF") << '\n';
+    std::cout << bq.numElements() << ' ' << bq.keyRange() << '\n';
+    printMin(bq);
+
+    // Extended API.
+    std::cout << "=======\n";
+    std::cout << bq.decreaseKey(2, 12) << ' ' << bq.decreaseKey(2, 2) << '\n';
+    printMin(bq);
+    std::cout << bq.increaseKey(2, 4) << ' ' << *(bq.getKey(2)) << '\n';
+    std::cout << bq.increaseKey(1, 6) << '\n';
+    printMin(bq);
+    std::cout << bq.remove(3) << ' ' << bq.remove(3) << '\n';
+    std::cout << (bq.get(3) == nullptr) << ' ' << *(bq.get(1)) << '\n';
+
+    // Drain in priority order, ties in insertion order.
+    std::cout << "-------\n";
+    while(bq.numElements() > 0) {
+        printMin(bq);
+        bq.deleteMin();
+    }
+    std::cout << bq.deleteMin() << '\n';
+}
@@ -0,0 +1,47 @@
+#include "calendar_queue.hpp"
+
+#include <iostream>
+#include <string>
+
+static void printMin(const CalendarQueue<std::string>& cq)
+{
+    std::cout << "Min: " << *(cq.getMinId()) << ' ' << *(cq.getMinKey()) << ' '
+        << *(cq.getMinValue()) << '\n';
+}
+
+int main()
+{
+    std::cout << std::boolalpha;
+
+    // Basic operations.
+    CalendarQueue<std::string> cq;
+    std::cout << cq.insert(1, 100, "AA") << '\n';
+    cq.insert(2, 130, "BB");
+    cq.insert(3, 80, "CC");
+    cq.insert(4, 50, "DD");
+    cq.insert(5, 50, "EE");
+    std::cout << cq.insert(3, 1, "dup") << '\n';
+    std::cout << cq.numElements() << ' ' << *(cq.getKey(2)) << ' ' << *(cq.get(2)) << '\n';
+    printMin(cq);
+    std::cout << cq.remove(3) << ' ' << cq.remove(3) << '\n';
+
+    // The calendar resizes as events come and go.
+    std::cout << "=======\n";
+    std::cout << cq.bucketCount() << ' ' << cq.bucketWidth() << '\n';
+    for(unsigned id = 10; id < 30; id++) {
+        cq.insert(id, 1000 + 10*id, "event");
+    }
+    std::cout << cq.bucketCount() << ' ' << cq.bucketWidth() << '\n';
+    for(unsigned i = 0; i < 18; i++) {
+        cq.deleteMin();
+    }
+    std::cout << cq.bucketCount() << ' ' << cq.bucketWidth() << '\n';
+
+    // Drain in priority order.
+    std::cout << "-------\n";
+    while(cq.numElements() > 0) {
+        printMin(cq);
+        cq.deleteMin();
+    }
+    std::cout << cq.deleteMin() << '\n';
+}
@@ -0,0 +1,58 @@
+#include "concurrent_priority_queue.hpp"
+
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+int main()
+{
+    std::cout << std::boolalpha;
+
+    // Four threads insert 1000 elements each.
+    ConcurrentPriorityQueue<std::string> cpq(4000);
+    std::cout << cpq.maxSize() << '\n';
+    std::vector<std::thread> workers;
+    for(unsigned t = 0; t < 4; t++) {
+        workers.emplace_back([&cpq, t]() {
+            for(unsigned i = 0; i < 1000; i++) {
+                unsigned id = 1000*t + i;
+                cpq.insert(id, id % 97 + 10, "v" + std::to_string(id));
+            }
+        });
+    }
+    for(unsigned t = 0; t < 4; t++) {
+        workers[t].join();
+    }
+    std::cout << cpq.numElements() << ' ' << cpq.insert(5, 1, "dup") << ' ' << cpq.insert(9999, 1, "full") << '\n';
+
+    // The extended API works through the position map.
+    unsigned key = 0;
+    std::cout << cpq.getKey(2500, key) << ' ' << key << '\n';
+    std::cout << cpq.decreaseKey(2500, key) << ' ' << cpq.getKey(9999, key) << '\n';
+
+    // Four threads remove elements concurrently, each in strict order.
+    std::cout << "=======\n";
+    Element<std::string> out;
+    cpq.deleteMin(out);
+    std::cout << out.id << ' ' << out.key << ' ' << out.value << '\n';
+    std::vector<unsigned> counts(4, 0);
+    std::vector<bool> sorted(4, true);
+    workers.clear();
+    for(unsigned t = 0; t < 4; t++) {
+        workers.emplace_back([&cpq, &counts, &sorted, t]() {
+            Element<std::string> element;
+            unsigned last = 0;
+            while(cpq.deleteMin(element)) {
+                sorted[t] = sorted[t] && element.key >= last;
+                last = element.key;
+                counts[t]++;
+            }
+        });
+    }
+    for(unsigned t = 0; t < 4; t++) {
+        workers[t].join();
+    }
+    std::cout << counts[0] + counts[1] + counts[2] + counts[3] << ' ' << (sorted[0] && sorted[1] && sorted[2] && sorted[3]) << '\n';
+    std::cout << cpq.deleteMin(out) << ' ' << cpq.numElements() << '\n';
+}
@@ -1,5 +1,6 @@
 #include "hash_table.hpp"
 
+#include <climits>
 #include <iostream>
 
 // For forcing use of const overload of get().
@@ -105,4 +106,10 @@ int main()
     b.insert(3, "EE");
     HashTable<std::string> c = a + b;
     std::cout << c;
+
+    // The largest key.
+    std::cout << "=== UINT_MAX ===\n";
+    HashTable<std::string> d(7);
+    std::cout << d.insert(UINT_MAX, "max") << ' ' << d.insert(UINT_MAX, "dup") << '\n';
+    std::cout << *(d.get(UINT_MAX)) << ' ' << d.remove(UINT_MAX) << ' ' << (d.get(UINT_MAX) == nullptr) << '\n';
 }
@@ -0,0 +1,56 @@
+#include "lazy_priority_queue.hpp"
+
+#include <iostream>
+#include <string>
+
+static void printMin(const LazyPriorityQueue<std::string>& lq)
+{
+    std::cout << "Min: " << *(lq.getMinId()) << ' ' << *(lq.getMinKey()) << ' '
+        << *(lq.getMinValue()) << '\n';
+}
+
+int main()
+{
+    std::cout << std::boolalpha;
+
+    // Basic operations.
+    LazyPriorityQueue<std::string> lq;
+    std::cout << lq.insert(1, 10, "AA") << '\n';
+    lq.insert(2, 13, "BB");
+    lq.insert(3, 8, "CC");
+    lq.insert(4, 5, "DD");
+    lq.insert(5, 5, "EE");
+    std::cout << lq.insert(3, 1, "dup") << '\n';
+    std::cout << lq.numElements() << '\n';
+    printMin(lq);
+
+    // Cancelling and rescheduling leave stale entries behind.
+    std::cout << "=======\n";
+    std::cout << lq.decreaseKey(2, 12) << ' ' << lq.numStale() << '\n';
+    printMin(lq);
+    std::cout << lq.increaseKey(2, 20) << ' ' << *(lq.getKey(2)) << ' ' << lq.numStale() << '\n';
+    std::cout << lq.remove(3) << ' ' << lq.remove(3) << ' ' << lq.numStale() << '\n';
+    std::cout << (lq.get(3) == nullptr) << ' ' << *(lq.get(1)) << '\n';
+    std::cout << lq.insert(3, 6, "CC2") << ' ' << *(lq.get(3)) << '\n';
+    lq.compact();
+    std::cout << lq.numStale() << ' ' << lq.numElements() << '\n';
+
+    // Drain in priority order.
+    std::cout << "-------\n";
+    while(lq.numElements() > 0) {
+        printMin(lq);
+        lq.deleteMin();
+    }
+    std::cout << lq.deleteMin() << '\n';
+
+    // Cancel most of what was inserted: compaction keeps the heap small.
+    std::cout << "#######\n";
+    for(unsigned id = 0; id < 10000; id++) {
+        lq.insert(id, id % 1000, "x");
+        if(id % 10 != 0) {
+            lq.remove(id);
+        }
+    }
+    std::cout << lq.numElements() << ' ' << (lq.numStale() <= lq.numElements()) << '\n';
+    printMin(lq);
+}
@@ -0,0 +1,42 @@
+#include "multi_queue.hpp"
+
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+int main()
+{
+    std::cout << std::boolalpha;
+
+    // Four threads insert 1000 elements each.
+    MultiQueue<std::string> mq(4);
+    std::cout << mq.numShards() << '\n';
+    std::vector<std::thread> workers;
+    for(unsigned t = 0; t < 4; t++) {
+        workers.emplace_back([&mq, t]() {
+            for(unsigned i = 0; i < 1000; i++) {
+                unsigned id = 1000*t + i;
+                mq.insert(id, id % 97, "v" + std::to_string(id));
+            }
+        });
+    }
+    for(unsigned t = 0; t < 4; t++) {
+        workers[t].join();
+    }
+    std::cout << mq.numElements() << '\n';
+
+    // Elements come out roughly, not exactly, in priority order.
+    std::cout << "=======\n";
+    Element<std::string> out;
+    unsigned total = 0;
+    unsigned firstKeys = 0;
+    for(unsigned i = 0; mq.deleteMin(out); i++) {
+        if(i < 100) {
+            firstKeys += out.key;
+        }
+        total++;
+    }
+    std::cout << total << ' ' << (firstKeys / 100 < 10) << ' ' << mq.numElements() << '\n';
+    std::cout << mq.deleteMin(out) << '\n';
+}
@@ -0,0 +1,63 @@
+#include "pairing_heap.hpp"
+
+#include <iostream>
+#include <string>
+
+static void printMin(const PairingHeap<std::string>& ph)
+{
+    std::cout << "Min: " << *(ph.getMinId()) << ' ' << *(ph.getMinKey()) << ' '
+        << *(ph.getMinValue()) << '\n';
+}
+
+int main()
+{
+    std::cout << std::boolalpha;
+
+    // Basic operations.
+    PairingHeap<std::string> ph;
+    std::cout << ph.insert(1, 10, "AA") << '\n';
+    ph.insert(2, 13, "BB");
+    ph.insert(3, 8, "CC");
+    ph.insert(4, 5, "DD");
+    ph.insert(5, 5, "EE");
+    std::cout << ph.insert(3, 1, "dup") << '\n';
+    std::cout << ph.numElements() << '\n';
+    printMin(ph);
+
+    // Extended API.
+    std::cout << "=======\n";
+    std::cout << ph.decreaseKey(2, 12) << '\n';
+    printMin(ph);
+    std::cout << ph.increaseKey(2, 20) << ' ' << *(ph.getKey(2)) << '\n';
+    printMin(ph);
+    std::cout << ph.remove(3) << ' ' << ph.remove(3) << '\n';
+    std::cout << (ph.get(3) == nullptr) << ' ' << *(ph.get(1)) << '\n';
+
+    // Drain in priority order.
+    std::cout << "-------\n";
+    while(ph.numElements() > 0) {
+        printMin(ph);
+        ph.deleteMin();
+    }
+    std::cout << ph.deleteMin() << '\n';
+
+    // Merging two heaps.
+    std::cout << "#######\n";
+    PairingHeap<std::string> a;
+    PairingHeap<std::string> b;
+    a.insert(1, 7, "AA");
+    a.insert(2, 3, "BB");
+    b.insert(3, 5, "CC");
+    b.insert(4, 1, "DD");
+    b.insert(5, 9, "EE");
+    std::cout << a.merge(std::move(b)) << '\n';
+    std::cout << a.numElements() << ' ' << b.numElements() << '\n';
+    PairingHeap<std::string> c;
+    c.insert(2, 0, "dup");
+    c.insert(6, 4, "FF");
+    std::cout << a.merge(std::move(c)) << ' ' << c.numElements() << '\n';
+    while(a.numElements() > 0) {
+        printMin(a);
+        a.deleteMin();
+    }
+}
@@ -1,6 +1,11 @@
 #include "priority_queue.hpp"
 
+#include <climits>
 #include <iostream>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
 
 int main()
 {
@@ -44,5 +49,139 @@ int main()
     std::cout << p2.insert(1, -3) << '\n';
     std::cout << p2.insert(2, -4) << '\n';
     std::cout << p2.insert(3, -5) << '\n';
-    
+
+    // Direct-indexed position map for small, dense keys.
+    std::cout << "%%%%%%%\n";
+    PriorityQueue<std::string, DirectIndexMap<unsigned>> p3(8);
+    p3.insert(4, "AA");
+    p3.insert(2, "BB");
+    p3.insert(6, "CC");
+    p3.insert(0, "DD");
+    std::cout << p3;
+    p3.deleteMin();
+    std::cout << *(p3.get(6)) << '\n';
+    std::cout << p3;
+    std::cout << p3.insert(1000, 1, "EE") << ' ' << *(p3.getMinValue()) << '\n'; //Grows the map past the hint.
+
+    // Separate ids and priorities; priorities may repeat.
+    std::cout << "^^^^^^^\n";
+    PriorityQueue<std::string> p4(10);
+    p4.insert(100, 5, "job-a");
+    p4.insert(101, 5, "job-b");
+    p4.insert(102, 9, "job-c");
+    std::cout << p4.insert(100, 1, "dup") << '\n';
+    std::cout << p4.decreaseKey(102, 6) << '\n';
+    std::cout << *(p4.getMinId()) << ' ' << *(p4.getMinKey()) << ' '
+        << *(p4.getMinValue()) << '\n';
+    std::cout << p4.increaseKey(102, 10) << ' ' << *(p4.getKey(102)) << '\n';
+    p4.deleteMin();
+    p4.deleteMin();
+    std::cout << *(p4.getMinId()) << ' ' << *(p4.get(102)) << '\n';
+    std::cout << p4.insert(UINT_MAX, 0, "max-id") << ' ' << *(p4.getMinId()) << ' '
+        << *(p4.getMinValue()) << ' ' << p4.remove(UINT_MAX) << '\n';
+
+    // Growable priority queue.
+    std::cout << "&&&&&&&\n";
+    PriorityQueue<int> p5;
+    p5.setAutoShrink(true);
+    for(unsigned i = 0; i < 100; i++) {
+        p5.insert(i, 100-i, i);
+    }
+    std::cout << p5.numElements() << ' ' << p5.maxSize() << ' '
+        << *(p5.getMinValue()) << '\n';
+    while(p5.numElements() > 5) {
+        p5.deleteMin();
+    }
+    std::cout << p5.numElements() << ' ' << p5.maxSize() << '\n';
+    std::cout << p5;
+    p5.reserve(1000);
+    std::cout << p5.maxSize() << '\n';
+
+    // Bulk construction with heapify.
+    std::cout << "+++++++\n";
+    std::vector<Element<std::string>> elements = {
+        {1, 40, "AA"}, {2, 10, "BB"}, {3, 30, "CC"}, {4, 20, "DD"}, {5, 50, "EE"}
+    };
+    PriorityQueue<std::string> p6(elements.begin(), elements.end());
+    std::cout << p6;
+    std::cout << *(p6.get(3)) << '\n';
+    PriorityQueue<std::string> p7(3);
+    std::cout << p7.assign(elements.begin(), elements.end()) << '\n';
+    std::cout << p7.assign(elements.begin(), elements.begin()+3) << '\n';
+    std::cout << p7;
+
+    // Batch insert and batch deleteMin.
+    std::cout << "///////\n";
+    std::cout << p7.insertBatch(elements.begin(), elements.end()) << '\n';
+    std::vector<Element<std::string>> drained;
+    std::cout << p6.deleteMinBatch(3, std::back_inserter(drained)) << '\n';
+    for(unsigned i = 0; i < drained.size(); i++) {
+        std::cout << drained[i].id << ' ' << drained[i].key << ' '
+            << drained[i].value << '\n';
+    }
+    std::cout << p6;
+
+    // Fused deleteMin + insert.
+    std::cout << "~~~~~~~\n";
+    std::cout << p6.replaceMin(6, 60, "FF") << '\n';
+    std::cout << p6;
+    Element<std::string> popped;
+    std::cout << p6.pushPop(7, 45, "GG", popped) << ' ' << popped.id << ' '
+        << popped.key << ' ' << popped.value << '\n';
+    std::cout << p6.pushPop(8, 5, "HH", popped) << ' ' << popped.id << ' '
+        << popped.key << ' ' << popped.value << '\n';
+    std::cout << p6.pushPop(6, 1, "II", popped) << '\n';
+    std::cout << p6;
+
+    // Merging two queues.
+    std::cout << "|||||||\n";
+    PriorityQueue<std::string> p8;
+    p8.insert(20, 15, "JJ");
+    p8.insert(21, 55, "KK");
+    std::cout << p6.merge(std::move(p8)) << ' ' << p8.numElements() << '\n';
+    std::cout << p6;
+    PriorityQueue<std::string> p10;
+    p10.insert(20, 2, "MM");
+    std::cout << p6.merge(std::move(p10)) << ' ' << p10.numElements() << ' ' << *(p6.get(20)) << '\n';
+    PriorityQueue<std::string> p9(1);
+    p9.insert(22, 1, "LL");
+    std::cout << p9.merge(std::move(p6)) << ' ' << p6.numElements() << '\n';
+    PriorityQueue<std::string> p11(std::move(p10));
+    std::cout << p11.merge(std::move(p10)) << ' ' << p11.numElements() << '\n'; //p10 is moved-from.
+
+    // Other orders and key types.
+    std::cout << "^^^^^^^\n";
+    PriorityQueue<std::string, HashTable<unsigned>, 2, unsigned, std::greater<unsigned>> maxQueue;
+    maxQueue.insert(1, 10, "AA");
+    maxQueue.insert(2, 30, "BB");
+    maxQueue.insert(3, 20, "CC");
+    std::cout << *maxQueue.getMinKey() << ' ' << *maxQueue.getMinValue() << '\n';
+    maxQueue.decreaseKey(2, 25);
+    std::cout << *maxQueue.getMinKey() << ' ' << *maxQueue.getMinValue() << '\n';
+
+    PriorityQueue<std::string, HashTable<unsigned>, 2, double> deadlines;
+    deadlines.insert(1, 2.5, "later");
+    deadlines.insert(2, 0.75, "sooner");
+    std::cout << *deadlines.getMinKey() << ' ' << *deadlines.getMinValue() << '\n';
+
+    PriorityQueue<std::string, HashTable<unsigned>, 2, std::pair<unsigned, unsigned>> tuples;
+    tuples.insert(1, std::make_pair(1u, 9u), "AA");
+    tuples.insert(2, std::make_pair(1u, 3u), "BB");
+    tuples.insert(3, std::make_pair(2u, 0u), "CC");
+    std::cout << *tuples.getMinValue() << ' ';
+    tuples.updateKey(3, std::make_pair(0u, 5u));
+    std::cout << *tuples.getMinValue() << '\n';
+
+    // A comparator with state: keys closest to a target come out first.
+    unsigned target = 50;
+    auto closer = [target](unsigned a, unsigned b) {
+        return (a > target ? a-target : target-a) < (b > target ? b-target : target-b);
+    };
+    PriorityQueue<std::string, HashTable<unsigned>, 2, unsigned, decltype(closer)> nearest(closer);
+    nearest.insert(1, 10, "AA");
+    nearest.insert(2, 58, "BB");
+    nearest.insert(3, 45, "CC");
+    std::cout << *nearest.getMinKey() << ' ' << *nearest.getMinValue() << '\n';
+    nearest.updateKey(2, 51);
+    std::cout << *nearest.getMinKey() << ' ' << *nearest.getMinValue() << '\n';
 }
@@ -0,0 +1,46 @@
+#include "priority_scheduler.hpp"
+
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+int main()
+{
+    // With a single worker, queued tasks run in priority order.
+    std::vector<unsigned> order;
+    {
+        PriorityScheduler single(1);
+        std::atomic<bool> go(false);
+        single.submit(0, [&go]() {
+            while(!go) {
+                std::this_thread::yield();
+            }
+        });
+        unsigned keys[] = {5, 3, 9, 1, 7};
+        for(unsigned k : keys) {
+            single.submit(k, [&order, k]() { order.push_back(k); });
+        }
+        go = true;
+    }
+    for(unsigned k : order) {
+        std::cout << k << ' ';
+    }
+    std::cout << '\n';
+
+    // Tasks submitted from tasks stay on their worker, and idle
+    // workers steal the rest.
+    std::cout << "=======\n";
+    std::atomic<unsigned> ran(0);
+    PriorityScheduler pool(4);
+    for(unsigned i = 0; i < 100; i++) {
+        pool.submit(i, [&pool, &ran]() {
+            ran++;
+            for(unsigned j = 0; j < 10; j++) {
+                pool.submit(j, [&ran]() { ran++; });
+            }
+        });
+    }
+    pool.waitIdle();
+    std::cout << pool.numWorkers() << ' ' << ran << '\n';
+}
@@ -0,0 +1,47 @@
+#include "radix_heap.hpp"
+
+#include <iostream>
+#include <string>
+
+static void printMin(const RadixHeap<std::string>& rh)
+{
+    std::cout << "Min: " << *(rh.getMinId()) << ' ' << *(rh.getMinKey()) << ' '
+        << *(rh.getMinValue()) << '\n';
+}
+
+int main()
+{
+    std::cout << std::boolalpha;
+
+    // Basic operations.
+    RadixHeap<std::string> rh;
+    std::cout << rh.insert(1, 10, "AA") << '\n';
+    rh.insert(2, 13, "BB");
+    rh.insert(3, 8, "CC");
+    rh.insert(4, 40, "DD");
+    rh.insert(5, 8, "EE");
+    std::cout << rh.insert(3, 20, "dup") << '\n';
+    std::cout << rh.numElements() << ' ' << rh.lastKey() << '\n';
+    printMin(rh);
+
+    // Priorities are monotone: nothing below the current minimum.
+    std::cout << "=======\n";
+    rh.deleteMin();
+    rh.deleteMin();
+    printMin(rh);
+    std::cout << rh.insert(6, 9, "FF") << ' ' << rh.insert(6, 10, "FF") << '\n';
+    std::cout << rh.decreaseKey(4, 35) << ' ' << rh.decreaseKey(4, 25) << '\n';
+    printMin(rh);
+    std::cout << rh.increaseKey(1, 5) << ' ' << *(rh.getKey(1)) << '\n';
+    printMin(rh);
+    std::cout << rh.remove(2) << ' ' << rh.remove(2) << '\n';
+    std::cout << (rh.get(2) == nullptr) << ' ' << *(rh.get(4)) << '\n';
+
+    // Drain in priority order.
+    std::cout << "-------\n";
+    while(rh.numElements() > 0) {
+        printMin(rh);
+        rh.deleteMin();
+    }
+    std::cout << rh.deleteMin() << ' ' << rh.lastKey() << '\n';
+}
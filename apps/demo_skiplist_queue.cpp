@@ -0,0 +1,45 @@
+#include "skiplist_queue.hpp"
+
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+int main()
+{
+    std::cout << std::boolalpha;
+
+    // Four threads insert 1000 elements each.
+    SkipListQueue<std::string> sq;
+    std::vector<std::thread> workers;
+    for(unsigned t = 0; t < 4; t++) {
+        workers.emplace_back([&sq, t]() {
+            for(unsigned i = 0; i < 1000; i++) {
+                unsigned id = 1000*t + i;
+                sq.insert(id, id % 997, "v" + std::to_string(id));
+            }
+        });
+    }
+    for(unsigned t = 0; t < 4; t++) {
+        workers[t].join();
+    }
+    std::cout << sq.numElements() << '\n';
+
+    // Key lookup.
+    Element<std::string> out;
+    std::cout << sq.find(5, out) << ' ' << out.key << '\n';
+    std::cout << sq.find(2000, out) << '\n';
+
+    // Elements come out in exact priority order.
+    std::cout << "=======\n";
+    unsigned total = 0;
+    unsigned previous = 0;
+    bool sorted = true;
+    while(sq.deleteMin(out)) {
+        sorted = sorted && previous <= out.key;
+        previous = out.key;
+        total++;
+    }
+    std::cout << total << ' ' << sorted << ' ' << sq.numElements() << '\n';
+    std::cout << sq.deleteMin(out) << '\n';
+}
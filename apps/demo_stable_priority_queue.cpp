@@ -0,0 +1,58 @@
+#include "stable_priority_queue.hpp"
+
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+static void printMin(const StablePriorityQueue<std::string>& sq)
+{
+    std::cout << "Min: " << *(sq.getMinId()) << ' ' << *(sq.getMinKey()) << ' '
+        << *(sq.getMinValue()) << '\n';
+}
+
+int main()
+{
+    std::cout << std::boolalpha;
+
+    // Elements with equal priorities come out in insertion order.
+    StablePriorityQueue<std::string> sq;
+    std::cout << sq.insert(1, 5, "first") << '\n';
+    sq.insert(2, 3, "AA");
+    sq.insert(3, 5, "second");
+    sq.insert(4, 5, "third");
+    sq.insert(5, 3, "BB");
+    std::cout << sq.insert(3, 1, "dup") << '\n';
+    std::cout << sq.numElements() << '\n';
+    printMin(sq);
+
+    // Changing a priority keeps the element's place in insertion order.
+    std::cout << "=======\n";
+    std::cout << sq.decreaseKey(4, 2) << ' ' << *(sq.getKey(4)) << '\n';
+    std::cout << sq.increaseKey(5, 2) << ' ' << *(sq.getKey(5)) << '\n';
+    std::cout << sq.decreaseKey(4, 0) << ' ' << sq.remove(2) << ' ' << sq.remove(2) << '\n';
+    std::cout << (sq.get(2) == nullptr) << ' ' << *(sq.get(1)) << '\n';
+
+    // Drain in priority order, oldest first among ties.
+    std::cout << "-------\n";
+    while(sq.numElements() > 0) {
+        printMin(sq);
+        sq.deleteMin();
+    }
+    std::cout << sq.deleteMin() << '\n';
+
+    // Requests at four priority levels, taken out in batches.
+    std::cout << "#######\n";
+    StablePriorityQueue<unsigned> requests(16);
+    for(unsigned id = 0; id < 16; id++) {
+        requests.insert(id, id % 4, id);
+    }
+    std::vector<Element<unsigned>> batch;
+    while(requests.deleteMinBatch(5, std::back_inserter(batch)) > 0) {
+        for(unsigned i = 0; i < batch.size(); i++) {
+            std::cout << "(" << batch[i].key << "," << batch[i].value << ") ";
+        }
+        std::cout << '\n';
+        batch.clear();
+    }
+}
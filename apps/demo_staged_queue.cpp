@@ -0,0 +1,60 @@
+#include "staged_queue.hpp"
+
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+int main()
+{
+    std::cout << std::boolalpha;
+
+    // Two producers with their own rings, one through the shared ring.
+    StagedQueue<std::string> sq(2, 256);
+    std::cout << sq.numProducers() << '\n';
+    std::vector<std::thread> producers;
+    for(unsigned p = 0; p < 3; p++) {
+        producers.emplace_back([&sq, p]() {
+            for(unsigned i = 0; i < 200; i++) {
+                unsigned id = 1000*p + i;
+                std::string value = "v" + std::to_string(id);
+                while(!(p < 2 ? sq.push(p, id, id % 50, value) : sq.push(id, id % 50, value))) {
+                    std::this_thread::yield(); //Ring full: wait for the consumer.
+                }
+            }
+        });
+    }
+    for(unsigned p = 0; p < 3; p++) {
+        producers[p].join();
+    }
+
+    // Nothing is in the heap until the consumer drains.
+    std::cout << sq.numElements() << '\n';
+    std::cout << *sq.getMinKey() << ' ' << sq.numElements() << '\n';
+
+    // A full ring refuses more elements.
+    StagedQueue<std::string> small(1, 2);
+    std::cout << small.push(0, 1, 1, "a") << small.push(0, 2, 2, "b") << small.push(0, 3, 3, "c") << '\n';
+    std::cout << small.drain() << ' ' << small.push(0, 3, 3, "c") << '\n';
+
+    // The consumer takes elements out in priority order.
+    std::cout << "=======\n";
+    Element<std::string> out;
+    unsigned total = 0;
+    unsigned lastKey = 0;
+    bool sorted = true;
+    while(sq.deleteMin(out)) {
+        sorted = sorted && out.key >= lastKey;
+        lastKey = out.key;
+        total++;
+    }
+    std::cout << total << ' ' << sorted << ' ' << sq.deleteMin(out) << '\n';
+
+    // The rest of the extended API is on the heap.
+    std::cout << "=======\n";
+    sq.push(7, 70, "seven");
+    sq.push(0, 8, 80, "eight");
+    sq.drain();
+    sq.heap().decreaseKey(8, 75);
+    std::cout << *sq.getMinValue() << ' ' << *sq.getMinKey() << '\n';
+}
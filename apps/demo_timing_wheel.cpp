@@ -0,0 +1,42 @@
+#include "timing_wheel.hpp"
+
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+static void printExpired(const std::vector<Element<std::string>>& expired)
+{
+    for(unsigned i = 0; i < expired.size(); i++) {
+        std::cout << '(' << expired[i].id << ',' << expired[i].key << ',' << expired[i].value << ") ";
+    }
+    std::cout << '\n';
+}
+
+int main()
+{
+    std::cout << std::boolalpha;
+
+    // Scheduling and cancelling timers.
+    TimingWheel<std::string> wheel;
+    std::cout << wheel.insert(1, 10, "AA") << '\n';
+    wheel.insert(2, 70, "BB");
+    wheel.insert(3, 5000, "CC");
+    wheel.insert(4, 10, "DD");
+    wheel.insert(5, 300000, "EE");
+    std::cout << wheel.insert(3, 20, "dup") << '\n';
+    std::cout << wheel.numElements() << ' ' << *(wheel.getKey(3)) << ' ' << *(wheel.get(3)) << '\n';
+    std::cout << wheel.remove(4) << ' ' << wheel.remove(4) << '\n';
+
+    // Expiring due timers.
+    std::cout << "=======\n";
+    std::vector<Element<std::string>> expired;
+    std::cout << wheel.advance(9, std::back_inserter(expired)) << ' ' << wheel.currentTime() << '\n';
+    std::cout << wheel.advance(100, std::back_inserter(expired)) << ' ' << wheel.currentTime() << '\n';
+    printExpired(expired);
+    wheel.insert(6, 50, "FF"); //Already overdue.
+    wheel.insert(7, 4000, "GG");
+    expired.clear();
+    std::cout << wheel.advance(1000000, std::back_inserter(expired)) << ' ' << wheel.numElements() << '\n';
+    printExpired(expired);
+}
@@ -40,7 +40,7 @@ int main()
    std::cout << x << std::endl;
    x.remove(98);
    std::cout << x << std::endl;
-   x.decreaseKey(120,119);
+   x.decreaseKey(20,119); //Id 20 keeps its id after increaseKey() moved its key to 120.
    std::cout << x << std::endl;
 
 }
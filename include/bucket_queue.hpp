@@ -0,0 +1,346 @@
+#ifndef BUCKET_QUEUE_HPP
+#define BUCKET_QUEUE_HPP
+
+#include "hash_table.hpp"
+#include "direct_index_map.hpp"
+#include "node_pool.hpp"
+
+#include <stdexcept>
+#include <vector>
+
+/**
+ * Implementation of a bucket queue (as in Dial's algorithm) with
+ * the same extended API as PriorityQueue, for priorities that lie
+ * in a small range [0, keyRange), such as QoS levels.
+ *
+ * There is one bucket per priority. A bucket is an intrusive,
+ * circular doubly linked list of nodes, so elements can be
+ * unlinked from the middle of it, and elements with the same
+ * priority come out in insertion order. A bitmap with one bit per
+ * bucket, plus a summary bitmap with one bit per 64 buckets, tells
+ * which buckets are non-empty; the next minimum is found with a
+ * count-trailing-zeros on those words rather than by walking the
+ * buckets.
+ *
+ * Every operation is O(1), except that emptying the smallest
+ * bucket scans the summary bitmap, i.e. keyRange/4096 words
+ * (a single word up to 4096 priorities).
+ *
+ * Since the lists are intrusive, decreaseKey, increaseKey and
+ * remove find the node from its id and unlink it directly,
+ * without walking its bucket.
+ */
+template <typename ValueType, typename PositionMap = HashTable<unsigned>>
+class BucketQueue
+{
+public:
+    /**
+     * Creates an empty bucket queue for priorities in [0, @keyRange).
+     */
+    explicit BucketQueue(unsigned keyRange) : heads(keyRange, none), bits((keyRange+63)/64), summary((keyRange+4095)/4096),
+        data(initialMapSize), minBucket(none), elementCount(0) {
+        if(keyRange == 0) {
+            throw std::runtime_error("keyRange cannot be <= 0!");
+        }
+    };
+
+    /**
+     * Makes room for @capacity nodes, so that inserting up to
+     * that many elements does not reallocate the node pool.
+     */
+    void reserve(unsigned capacity) {
+        nodes.reserve(capacity);
+    };
+
+    /**
+     * All of these must run in constant time.
+     */
+    unsigned numElements() const {
+        return elementCount;
+    };
+
+    unsigned keyRange() const {
+        return heads.size();
+    };
+
+    /**
+     * Inserts an element with identity @id and priority @key
+     * holding @value into the queue, after the elements that
+     * already have priority @key.
+     *
+     * This function runs in constant time (amortized over the
+     * growth of the node pool).
+     *
+     * Returns true if success.
+     * Returns false if any of the following
+     * (in which case, the insertion is not performed):
+     * - @id is already in the queue.
+     * - @key is not smaller than keyRange().
+     */
+    bool insert(unsigned id, unsigned key, const ValueType& value) {
+        if(key >= heads.size()) {
+            return false;
+        }
+
+        unsigned node = nodes.allocate();
+        if(!data.insert(id, node)) {
+            nodes.release(node);
+            return false;
+        }
+
+        nodes[node].id = id;
+        nodes[node].key = key;
+        nodes[node].value = value;
+        link(node);
+        elementCount++;
+        return true;
+    };
+
+    /**
+     * Inserts a key-value pair mapping @key to @value, using
+     * @key both as the priority and as the identity of the element.
+     */
+    bool insert(unsigned key, const ValueType& value) {
+        return insert(key, key, value);
+    };
+
+    /**
+     * Returns key, id or value of the smallest element in the
+     * queue or null pointer if empty. Among elements with the
+     * same priority, the one inserted first is the smallest.
+     *
+     * These functions run in constant time.
+     *
+     * The pointer may be invalidated if the queue is modified.
+     */
+    const unsigned* getMinKey() const {
+        if(minBucket == none) {
+            return nullptr;
+        }
+        return &nodes[heads[minBucket]].key;
+    };
+
+    const unsigned* getMinId() const {
+        if(minBucket == none) {
+            return nullptr;
+        }
+        return &nodes[heads[minBucket]].id;
+    };
+
+    const ValueType* getMinValue() const {
+        if(minBucket == none) {
+            return nullptr;
+        }
+        return &nodes[heads[minBucket]].value;
+    };
+
+    /**
+     * Removes the smallest element of the queue.
+     *
+     * This function runs in constant time.
+     *
+     * Returns true if success.
+     * Returns false if queue is empty, i.e. nothing to delete.
+     */
+    bool deleteMin() {
+        if(minBucket == none) {
+            return false;
+        }
+
+        removeNode(heads[minBucket]);
+        return true;
+    };
+
+    /**
+     * Returns address of the value of the element with identity @id.
+     *
+     * These functions run in "constant time".
+     *
+     * Returns null pointer if @id is not in the queue.
+     *
+     * The pointer may be invalidated if an insert grows the node pool.
+     */
+    ValueType* get(unsigned id) {
+        const unsigned* node = data.get(id);
+        if(node == nullptr) {
+            return nullptr;
+        }
+        return &nodes[*node].value;
+    };
+
+    const ValueType* get(unsigned id) const {
+        const unsigned* node = data.get(id);
+        if(node == nullptr) {
+            return nullptr;
+        }
+        return &nodes[*node].value;
+    };
+
+    /**
+     * Returns address of the priority of the element with identity @id,
+     * or null pointer if @id is not in the queue.
+     */
+    const unsigned* getKey(unsigned id) const {
+        const unsigned* node = data.get(id);
+        if(node == nullptr) {
+            return nullptr;
+        }
+        return &nodes[*node].key;
+    };
+
+    /**
+     * Subtracts/adds @change from/to the priority of
+     * the element that has identity @id. The element moves to
+     * the back of the bucket of its new priority.
+     *
+     * These functions run in constant time.
+     *
+     * Returns true if success.
+     * Returns false if any of the following:
+     * - @change is 0.
+     * - @id not found.
+     * - The new priority would be outside of [0, keyRange()).
+     */
+    bool decreaseKey(unsigned id, unsigned change) {
+        const unsigned* found = data.get(id);
+        if(change == 0 || found == nullptr || change > nodes[*found].key) {
+            return false;
+        }
+
+        unsigned node = *found;
+        unlink(node);
+        nodes[node].key -= change;
+        link(node);
+        return true;
+    };
+
+    bool increaseKey(unsigned id, unsigned change) {
+        const unsigned* found = data.get(id);
+        if(change == 0 || found == nullptr || change >= heads.size() - nodes[*found].key) {
+            return false;
+        }
+
+        unsigned node = *found;
+        unlink(node);
+        nodes[node].key += change;
+        link(node);
+        return true;
+    };
+
+    /**
+     * Removes element that has identity @id.
+     *
+     * This function runs in constant time.
+     *
+     * Returns true if success.
+     * Returns false if @id not found.
+     */
+    bool remove(unsigned id) {
+        const unsigned* found = data.get(id);
+        if(found == nullptr) {
+            return false;
+        }
+
+        removeNode(*found);
+        return true;
+    };
+
+private:
+    struct Node {
+        unsigned id;
+        unsigned key;
+        ValueType value;
+        unsigned next; //Next node in the bucket, or next free node.
+        unsigned prev;
+    };
+
+    static constexpr unsigned none = ~0u;
+    static constexpr unsigned initialMapSize = 11;
+
+    NodePool<Node, &Node::next> nodes;
+    std::vector<unsigned> heads; //First node of each bucket.
+    std::vector<unsigned long long> bits; //Bit b%64 of word b/64 is set if bucket b is not empty.
+    std::vector<unsigned long long> summary; //Bit w%64 of word w/64 is set if bits[w] is not 0.
+    PositionMap data;
+    unsigned minBucket; //Smallest non-empty bucket, or none.
+    unsigned elementCount;
+
+    /**
+     * Adds @node to the back of the bucket of its key.
+     */
+    void link(unsigned node) {
+        unsigned bucket = nodes[node].key;
+        unsigned head = heads[bucket];
+        if(head == none) {
+            heads[bucket] = node;
+            nodes[node].next = node;
+            nodes[node].prev = node;
+            bits[bucket/64] |= 1ull << (bucket%64);
+            summary[bucket/4096] |= 1ull << (bucket/64%64);
+        } else {
+            unsigned tail = nodes[head].prev;
+            nodes[node].next = head;
+            nodes[node].prev = tail;
+            nodes[tail].next = node;
+            nodes[head].prev = node;
+        }
+
+        if(bucket < minBucket) {
+            minBucket = bucket;
+        }
+    }
+
+    /**
+     * Takes @node out of its bucket, updating the bitmaps and the
+     * minimum if the bucket becomes empty.
+     */
+    void unlink(unsigned node) {
+        unsigned bucket = nodes[node].key;
+        if(nodes[node].next == node) { //Only node in the bucket.
+            heads[bucket] = none;
+            bits[bucket/64] &= ~(1ull << (bucket%64));
+            if(bits[bucket/64] == 0) {
+                summary[bucket/4096] &= ~(1ull << (bucket/64%64));
+            }
+            if(bucket == minBucket) {
+                minBucket = findMinBucket();
+            }
+            return;
+        }
+
+        unsigned next = nodes[node].next;
+        unsigned prev = nodes[node].prev;
+        nodes[prev].next = next;
+        nodes[next].prev = prev;
+        if(heads[bucket] == node) {
+            heads[bucket] = next;
+        }
+    }
+
+    /**
+     * Returns the smallest non-empty bucket, or none if every
+     * bucket is empty.
+     */
+    unsigned findMinBucket() const {
+        for(unsigned s = minBucket/4096; s < summary.size(); s++) { //Buckets below minBucket are empty.
+            if(summary[s] != 0) {
+                unsigned word = 64*s + lowestBit(summary[s]);
+                return 64*word + lowestBit(bits[word]);
+            }
+        }
+        return none;
+    }
+
+    /**
+     * Unlinks @node from the queue, removes its id from the
+     * position map and frees it.
+     */
+    void removeNode(unsigned node) {
+        data.remove(nodes[node].id);
+        unlink(node);
+        nodes.release(node);
+        elementCount--;
+    }
+};
+
+#endif  // BUCKET_QUEUE_HPP
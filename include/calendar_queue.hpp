@@ -0,0 +1,413 @@
+#ifndef CALENDAR_QUEUE_HPP
+#define CALENDAR_QUEUE_HPP
+
+#include "hash_table.hpp"
+#include "direct_index_map.hpp"
+#include "node_pool.hpp"
+
+#include <algorithm>
+#include <vector>
+
+/**
+ * Implementation of a calendar queue (R. Brown, 1988) with the
+ * PriorityQueue extended API, for discrete-event simulation
+ * where the keys are timestamps.
+ *
+ * The queue is a "year" of bucketCount "days", each @width keys
+ * long: an element with key k goes to bucket (k / width) mod
+ * bucketCount, and each bucket is a circular linked list sorted
+ * by key.
+ * The next minimum is found by walking the days from the last
+ * minimum onwards and taking the first bucket head that falls in
+ * the day being looked at, so with about one element per day both
+ * insert and deleteMin take O(1) expected time. If a whole year
+ * goes by without a hit (a sparse queue), the heads of all buckets
+ * are searched directly instead.
+ *
+ * The calendar resizes itself: it doubles the number of days when
+ * there are more than two elements per day and halves it when
+ * there are fewer than one per two days. On each resize the day
+ * width is set from the spacing of the next events to come out
+ * (three times their average gap, ignoring outliers), so it
+ * follows the distribution of the timestamps.
+ *
+ * A resize relinks the existing nodes into the new days rather
+ * than copying the events, so the position map and the pointers
+ * returned by get() are left alone.
+ */
+template <typename ValueType, typename PositionMap = HashTable<unsigned>>
+class CalendarQueue
+{
+public:
+    /**
+     * Creates an empty calendar queue.
+     */
+    CalendarQueue() : heads(minBuckets, none), data(initialMapSize), width(1), minNode(none), elementCount(0) {};
+
+    /**
+     * Makes room for @capacity nodes, so that inserting up to
+     * that many elements does not reallocate the node pool.
+     */
+    void reserve(unsigned capacity) {
+        nodes.reserve(capacity);
+    };
+
+    /**
+     * All of these must run in constant time.
+     */
+    unsigned numElements() const {
+        return elementCount;
+    };
+
+    unsigned bucketCount() const {
+        return heads.size();
+    };
+
+    unsigned bucketWidth() const {
+        return width;
+    };
+
+    /**
+     * Inserts an element with identity @id and priority @key
+     * holding @value into the queue.
+     *
+     * This function runs in O(1) expected time, plus the occasional
+     * O(n) resize.
+     *
+     * Returns true if success.
+     * Returns false if @id is already in the queue
+     * (in which case, the insertion is not performed).
+     */
+    bool insert(unsigned id, unsigned key, const ValueType& value) {
+        unsigned node = nodes.allocate();
+        if(!data.insert(id, node)) {
+            nodes.release(node);
+            return false;
+        }
+
+        nodes[node].id = id;
+        nodes[node].key = key;
+        nodes[node].value = value;
+        link(node);
+        elementCount++;
+        if(minNode == none || key < nodes[minNode].key) {
+            minNode = node;
+        }
+
+        if(elementCount > 2*heads.size()) {
+            resize(2*heads.size());
+        }
+        return true;
+    };
+
+    /**
+     * Inserts a key-value pair mapping @key to @value, using
+     * @key both as the priority and as the identity of the element.
+     */
+    bool insert(unsigned key, const ValueType& value) {
+        return insert(key, key, value);
+    };
+
+    /**
+     * Returns key, id or value of the smallest element in the
+     * queue or null pointer if empty.
+     *
+     * These functions run in constant time.
+     *
+     * The pointer may be invalidated if the queue is modified.
+     */
+    const unsigned* getMinKey() const {
+        if(minNode == none) {
+            return nullptr;
+        }
+        return &nodes[minNode].key;
+    };
+
+    const unsigned* getMinId() const {
+        if(minNode == none) {
+            return nullptr;
+        }
+        return &nodes[minNode].id;
+    };
+
+    const ValueType* getMinValue() const {
+        if(minNode == none) {
+            return nullptr;
+        }
+        return &nodes[minNode].value;
+    };
+
+    /**
+     * Removes the smallest element of the queue.
+     *
+     * This function runs in O(1) expected time, plus the occasional
+     * O(n) resize.
+     *
+     * Returns true if success.
+     * Returns false if queue is empty, i.e. nothing to delete.
+     */
+    bool deleteMin() {
+        if(minNode == none) {
+            return false;
+        }
+
+        removeNode(minNode);
+        return true;
+    };
+
+    /**
+     * Returns address of the value of the element with identity @id.
+     *
+     * These functions run in "constant time".
+     *
+     * Returns null pointer if @id is not in the queue.
+     *
+     * The pointer may be invalidated if an insert grows the node pool.
+     */
+    ValueType* get(unsigned id) {
+        const unsigned* node = data.get(id);
+        if(node == nullptr) {
+            return nullptr;
+        }
+        return &nodes[*node].value;
+    };
+
+    const ValueType* get(unsigned id) const {
+        const unsigned* node = data.get(id);
+        if(node == nullptr) {
+            return nullptr;
+        }
+        return &nodes[*node].value;
+    };
+
+    /**
+     * Returns address of the priority of the element with identity @id,
+     * or null pointer if @id is not in the queue.
+     */
+    const unsigned* getKey(unsigned id) const {
+        const unsigned* node = data.get(id);
+        if(node == nullptr) {
+            return nullptr;
+        }
+        return &nodes[*node].key;
+    };
+
+    /**
+     * Removes element that has identity @id.
+     *
+     * This function runs in constant time, or like deleteMin
+     * if the element is the smallest one.
+     *
+     * Returns true if success.
+     * Returns false if @id not found.
+     */
+    bool remove(unsigned id) {
+        const unsigned* found = data.get(id);
+        if(found == nullptr) {
+            return false;
+        }
+
+        removeNode(*found);
+        return true;
+    };
+
+private:
+    struct Node {
+        unsigned id;
+        unsigned key;
+        ValueType value;
+        unsigned next; //Next node in the bucket, or next free node.
+        unsigned prev;
+    };
+
+    static constexpr unsigned none = ~0u;
+    static constexpr unsigned initialMapSize = 11;
+    static constexpr unsigned minBuckets = 2;
+    static constexpr unsigned sampleSize = 25;
+
+    NodePool<Node, &Node::next> nodes;
+    std::vector<unsigned> heads; //First (smallest) node of each bucket; the size is a power of 2.
+    PositionMap data;
+    unsigned width; //Keys per bucket ("day").
+    unsigned minNode;
+    unsigned elementCount;
+
+    unsigned bucketOf(unsigned key) const {
+        return (key / width) & (heads.size()-1);
+    }
+
+    /**
+     * Inserts @node into its bucket, after the nodes with a smaller
+     * or equal key. The search starts from the back of the bucket,
+     * since new events tend to be the latest ones, so appending and
+     * inserting after a run of equal keys take constant time.
+     */
+    void link(unsigned node) {
+        unsigned& head = heads[bucketOf(nodes[node].key)];
+        if(head == none) {
+            head = node;
+            nodes[node].next = node;
+            nodes[node].prev = node;
+            return;
+        }
+
+        unsigned prev = nodes[head].prev; //The tail.
+        while(nodes[prev].key > nodes[node].key && prev != head) {
+            prev = nodes[prev].prev;
+        }
+        if(nodes[prev].key > nodes[node].key) { //Smaller than everything: new head.
+            prev = nodes[head].prev;
+            head = node;
+        }
+
+        unsigned next = nodes[prev].next;
+        nodes[node].prev = prev;
+        nodes[node].next = next;
+        nodes[prev].next = node;
+        nodes[next].prev = node;
+    }
+
+    void unlink(unsigned node) {
+        unsigned& head = heads[bucketOf(nodes[node].key)];
+        if(nodes[node].next == node) { //Only node in the bucket.
+            head = none;
+            return;
+        }
+
+        unsigned next = nodes[node].next;
+        unsigned prev = nodes[node].prev;
+        nodes[prev].next = next;
+        nodes[next].prev = prev;
+        if(head == node) {
+            head = next;
+        }
+    }
+
+    /**
+     * Appends the nodes of every bucket to @out.
+     */
+    void collect(std::vector<unsigned>& out) const {
+        for(unsigned b = 0; b < heads.size(); b++) {
+            unsigned node = heads[b];
+            if(node == none) {
+                continue;
+            }
+            do {
+                out.push_back(node);
+                node = nodes[node].next;
+            } while(node != heads[b]);
+        }
+    }
+
+    /**
+     * Unlinks @node from the queue, removes its id from the
+     * position map and frees it. If it was the minimum, finds
+     * the next one.
+     */
+    void removeNode(unsigned node) {
+        unsigned key = nodes[node].key;
+        data.remove(nodes[node].id);
+        unlink(node);
+        nodes.release(node);
+        elementCount--;
+
+        if(node == minNode) {
+            minNode = findMin(key);
+        }
+        if(heads.size() > minBuckets && elementCount < heads.size()/2) {
+            resize(heads.size()/2);
+        }
+    }
+
+    /**
+     * Returns the smallest node, knowing that no key is smaller
+     * than @from: walks the calendar one day at a time starting at
+     * the day of @from, and falls back to comparing all bucket
+     * heads after a year without a hit.
+     */
+    unsigned findMin(unsigned from) const {
+        if(elementCount == 0) {
+            return none;
+        }
+
+        unsigned bucket = bucketOf(from);
+        unsigned long long dayEnd = (static_cast<unsigned long long>(from) / width + 1) * width;
+        for(unsigned i = 0; i < heads.size(); i++) {
+            unsigned head = heads[bucket];
+            if(head != none && nodes[head].key < dayEnd) {
+                return head;
+            }
+            bucket = (bucket+1) & (heads.size()-1);
+            dayEnd += width;
+        }
+
+        unsigned smallest = none;
+        for(unsigned b = 0; b < heads.size(); b++) {
+            unsigned head = heads[b];
+            if(head != none && (smallest == none || nodes[head].key < nodes[smallest].key)) {
+                smallest = head;
+            }
+        }
+        return smallest;
+    }
+
+    /**
+     * Returns a day width for the current elements: three times the
+     * average gap between the next sampleSize keys to come out,
+     * leaving out gaps larger than twice the overall average.
+     */
+    unsigned estimateWidth() const {
+        std::vector<unsigned> sample;
+        sample.reserve(elementCount);
+        collect(sample);
+        for(unsigned i = 0; i < sample.size(); i++) {
+            sample[i] = nodes[sample[i]].key;
+        }
+        if(sample.size() < 2) {
+            return width;
+        }
+
+        unsigned count = std::min<unsigned>(sample.size(), sampleSize);
+        std::partial_sort(sample.begin(), sample.begin()+count, sample.end());
+        unsigned long long total = sample[count-1] - sample[0];
+        unsigned long long limit = 2*total / (count-1);
+
+        unsigned long long kept = 0;
+        unsigned gaps = 0;
+        for(unsigned i = 1; i < count; i++) {
+            unsigned gap = sample[i] - sample[i-1];
+            if(gap <= limit) {
+                kept += gap;
+                gaps++;
+            }
+        }
+
+        unsigned long long estimate = (gaps == 0) ? 0 : 3*kept / gaps;
+        if(estimate == 0) {
+            return 1;
+        }
+        return (estimate > ~0u) ? ~0u : estimate;
+    }
+
+    /**
+     * Rebuilds the calendar with @newCount buckets and a new day
+     * width estimated from the current elements.
+     *
+     * This function runs in O(n) time.
+     */
+    void resize(unsigned newCount) {
+        unsigned newWidth = estimateWidth();
+
+        std::vector<unsigned> old;
+        old.reserve(elementCount);
+        collect(old);
+
+        heads.assign(newCount, none);
+        width = newWidth;
+        for(unsigned i = 0; i < old.size(); i++) {
+            link(old[i]);
+        }
+    }
+};
+
+#endif  // CALENDAR_QUEUE_HPP
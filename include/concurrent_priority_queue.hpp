@@ -0,0 +1,443 @@
+#ifndef CONCURRENT_PRIORITY_QUEUE_HPP
+#define CONCURRENT_PRIORITY_QUEUE_HPP
+
+#include "priority_queue.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * Implementation of a strictly ordered concurrent priority queue:
+ * an array heap with a lock on every node, after Hunt, Michael,
+ * Parthasarathy and Scott ("An Efficient Algorithm for Concurrent
+ * Priority Queue Heaps", 1996).
+ *
+ * Only the element count is behind a global lock, and only for as
+ * long as it takes to claim the slot at the end of the heap. Locks
+ * are always taken in the same order: the root, the count, then
+ * the other slots top-down.
+ * Percolating then locks a parent and a child at a time, always
+ * top-down, so operations in different parts of the heap run in
+ * parallel:
+ * - insert fills the new last slot, tags it with a ticket of its
+ *   own and percolates it up. A deleteMin percolating down may
+ *   move the element up under it; insert notices that the ticket
+ *   is no longer in its slot and follows it to the parent.
+ * - deleteMin takes the minimum out of the root, moves the last
+ *   element into it and percolates it down. Unlike in the paper,
+ *   it keeps the root locked while it fetches the last element, so
+ *   that element is never out of sight of another deleteMin, and
+ *   the keys each thread removes come out in order.
+ * Consecutive slots are handed out in bit-reversed order within
+ * each level of the tree, so consecutive inserts percolate up
+ * through different subtrees instead of contending on the same
+ * path.
+ *
+ * The position map (HashTable<unsigned> by default) maps each id
+ * to its current slot. It is split into stripes, each with its own
+ * lock, that are only held for a single lookup or update, never
+ * while waiting for a node. It makes insert reject duplicate ids
+ * and lets decreaseKey find an element; remove and increaseKey are
+ * not offered, since an element can only safely move up while
+ * other threads percolate.
+ *
+ * The capacity is fixed, as with PriorityQueue(maxSize). All member
+ * functions are safe to call from several threads at once.
+ */
+template <typename ValueType, typename PositionMap = HashTable<unsigned>>
+class ConcurrentPriorityQueue
+{
+public:
+    /**
+     * Creates a priority queue that holds at most @maxSize elements.
+     */
+    explicit ConcurrentPriorityQueue(unsigned maxSize) : slots(treeSize(maxSize)+1), stripes(stripeCount), capacity(maxSize), elementCount(0), nextTicket(firstTicket) {};
+
+    ConcurrentPriorityQueue(const ConcurrentPriorityQueue& rhs) = delete;
+    ConcurrentPriorityQueue& operator=(const ConcurrentPriorityQueue& rhs) = delete;
+
+    /**
+     * Returns the number of elements. It is exact when no other
+     * thread is modifying the queue.
+     */
+    unsigned numElements() const {
+        std::lock_guard<std::mutex> lock(countMutex);
+        return elementCount;
+    };
+
+    unsigned maxSize() const {
+        return capacity;
+    };
+
+    /**
+     * Inserts an element with identity @id and priority @key
+     * holding @value into the priority queue.
+     *
+     * This function runs in O(log n) time, plus waiting for locks.
+     *
+     * Returns true if success.
+     * Returns false if any of the following:
+     * - @id is already in the priority queue.
+     * - The priority queue is full.
+     * (In which case, the insertion is not performed.)
+     */
+    bool insert(unsigned id, unsigned key, const ValueType& value) {
+        if(!mapInsert(id)) {
+            return false;
+        }
+
+        std::unique_lock<std::mutex> countLock(countMutex);
+        bool rootLocked = false;
+        if(elementCount == 0) { //The root comes before the count in the lock order.
+            countLock.unlock();
+            slots[1].mutex.lock();
+            countLock.lock();
+            rootLocked = true;
+        }
+        if(elementCount == capacity) {
+            countLock.unlock();
+            if(rootLocked) {
+                slots[1].mutex.unlock();
+            }
+            mapRemove(id);
+            return false;
+        }
+        unsigned index = slotOf(++elementCount);
+        Slot& slot = slots[index];
+        if(index != 1) {
+            if(rootLocked) {
+                slots[1].mutex.unlock();
+            }
+            slot.mutex.lock();
+        }
+        countLock.unlock();
+
+        unsigned long long ticket = nextTicket.fetch_add(1, std::memory_order_relaxed);
+        slot.id = id;
+        slot.key = key;
+        slot.value = value;
+        slot.tag = ticket;
+        mapSet(id, index);
+        slot.mutex.unlock();
+
+        percolateUp(index, ticket);
+        return true;
+    };
+
+    /**
+     * Inserts a key-value pair mapping @key to @value, using
+     * @key both as the priority and as the identity of the element.
+     */
+    bool insert(unsigned key, const ValueType& value) {
+        return insert(key, key, value);
+    };
+
+    /**
+     * Removes the smallest element and writes it to @out.
+     *
+     * This function runs in O(log n) time, plus waiting for locks.
+     *
+     * Returns true if success.
+     * Returns false if queue is empty, i.e. nothing to delete.
+     */
+    bool deleteMin(Element<ValueType>& out) {
+        Slot& root = slots[1];
+        root.mutex.lock();
+        if(root.tag == emptyTag) {
+            root.mutex.unlock();
+            return false;
+        }
+        out = Element<ValueType>{root.id, root.key, std::move(root.value)};
+        mapRemove(root.id);
+
+        std::unique_lock<std::mutex> countLock(countMutex);
+        unsigned lastIndex = slotOf(elementCount--);
+        if(lastIndex == 1) { //The root was the only element.
+            root.tag = emptyTag;
+            countLock.unlock();
+            root.mutex.unlock();
+            return true;
+        }
+        Slot& last = slots[lastIndex];
+        last.mutex.lock();
+        countLock.unlock();
+
+        root.id = last.id;
+        root.key = last.key;
+        root.value = std::move(last.value);
+        root.tag = availableTag;
+        last.tag = emptyTag;
+        last.mutex.unlock();
+        mapSet(root.id, 1);
+        percolateDown();
+        return true;
+    };
+
+    /**
+     * Writes the priority of the element with identity @id to @key.
+     *
+     * Returns true if success.
+     * Returns false if @id is not in the priority queue.
+     */
+    bool getKey(unsigned id, unsigned& key) const {
+        unsigned index;
+        while(findSlot(id, index)) {
+            Slot& slot = slots[index];
+            std::lock_guard<std::mutex> lock(slot.mutex);
+            if(slot.tag != emptyTag && slot.id == id) {
+                key = slot.key;
+                return true;
+            }
+            std::this_thread::yield(); //Moved since the lookup.
+        }
+        return false;
+    };
+
+    /**
+     * Decreases the priority of the element with identity @id
+     * by @change and moves it up as needed.
+     *
+     * This function runs in O(log n) time, plus waiting for locks.
+     *
+     * Returns true if success.
+     * Returns false if any of the following:
+     * - @change is 0.
+     * - @id not found.
+     *
+     * As in PriorityQueue, underflow has an undefined effect.
+     */
+    bool decreaseKey(unsigned id, unsigned change) {
+        if(change == 0) {
+            return false;
+        }
+
+        unsigned index;
+        while(findSlot(id, index)) {
+            Slot& slot = slots[index];
+            slot.mutex.lock();
+            if(slot.tag != availableTag || slot.id != id) { //Moving, or still being inserted.
+                slot.mutex.unlock();
+                std::this_thread::yield();
+                continue;
+            }
+
+            slot.key -= change;
+            if(index == 1) {
+                slot.mutex.unlock();
+                return true;
+            }
+            unsigned long long ticket = nextTicket.fetch_add(1, std::memory_order_relaxed);
+            slot.tag = ticket;
+            slot.mutex.unlock();
+            percolateUp(index, ticket);
+            return true;
+        }
+        return false;
+    };
+
+private:
+    struct Slot {
+        std::mutex mutex;
+        unsigned long long tag = 0; //emptyTag, availableTag, or the ticket of the thread moving it up.
+        unsigned id;
+        unsigned key;
+        ValueType value;
+    };
+
+    struct alignas(64) Stripe {
+        std::mutex mutex;
+        PositionMap map{initialMapSize};
+    };
+
+    static constexpr unsigned long long emptyTag = 0;
+    static constexpr unsigned long long availableTag = 1;
+    static constexpr unsigned long long firstTicket = 2;
+    static constexpr unsigned none = ~0u; //Position of an id whose insert has not placed it yet.
+    static constexpr unsigned initialMapSize = 11;
+    static constexpr unsigned stripeCount = 64;
+
+    mutable std::vector<Slot> slots; //1-based; the size is a power of 2.
+    mutable std::vector<Stripe> stripes;
+    mutable std::mutex countMutex;
+    unsigned capacity;
+    unsigned elementCount;
+    std::atomic<unsigned long long> nextTicket;
+
+    /**
+     * Returns the number of nodes of the smallest full tree that
+     * has at least @maxSize nodes.
+     */
+    static unsigned treeSize(unsigned maxSize) {
+        if(maxSize == 0 || maxSize >= (1u << 31)) {
+            throw std::runtime_error("maxSize must be in [1, 2^31)!");
+        }
+        unsigned size = 1;
+        while(size < maxSize) {
+            size = 2*size + 1;
+        }
+        return size;
+    }
+
+    /**
+     * Returns the slot of the @count-th element: the levels are
+     * filled top-down, and each level in bit-reversed order.
+     */
+    static unsigned slotOf(unsigned count) {
+        unsigned level = 1;
+        while(2*level <= count) {
+            level *= 2;
+        }
+        unsigned offset = count - level;
+        unsigned reversed = 0;
+        for(unsigned bit = 1; bit < level; bit *= 2) {
+            reversed = 2*reversed + ((offset & bit) != 0);
+        }
+        return level + reversed;
+    }
+
+    Stripe& stripeOf(unsigned id) const {
+        return stripes[id % stripeCount];
+    }
+
+    bool mapInsert(unsigned id) {
+        Stripe& stripe = stripeOf(id);
+        std::lock_guard<std::mutex> lock(stripe.mutex);
+        return stripe.map.insert(id, none);
+    }
+
+    void mapSet(unsigned id, unsigned index) {
+        Stripe& stripe = stripeOf(id);
+        std::lock_guard<std::mutex> lock(stripe.mutex);
+        stripe.map.update(id, index);
+    }
+
+    void mapRemove(unsigned id) {
+        Stripe& stripe = stripeOf(id);
+        std::lock_guard<std::mutex> lock(stripe.mutex);
+        stripe.map.remove(id);
+    }
+
+    /**
+     * Looks up the slot of @id, waiting while its insert has not
+     * placed it yet.
+     *
+     * Returns false if @id is not in the priority queue.
+     */
+    bool findSlot(unsigned id, unsigned& index) const {
+        while(true) {
+            {
+                Stripe& stripe = stripeOf(id);
+                std::lock_guard<std::mutex> lock(stripe.mutex);
+                const unsigned* found = stripe.map.get(id);
+                if(found == nullptr) {
+                    return false;
+                }
+                index = *found;
+            }
+            if(index != none) {
+                return true;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    /**
+     * Swaps the elements of slots @a and @b, which the caller
+     * holds locked.
+     */
+    void swapSlots(unsigned a, unsigned b) {
+        std::swap(slots[a].tag, slots[b].tag);
+        std::swap(slots[a].id, slots[b].id);
+        std::swap(slots[a].key, slots[b].key);
+        std::swap(slots[a].value, slots[b].value);
+        mapSet(slots[a].id, a);
+        mapSet(slots[b].id, b);
+    }
+
+    /**
+     * Moves the element tagged @ticket up from slot @index until
+     * its parent is not larger, then marks it available.
+     */
+    void percolateUp(unsigned index, unsigned long long ticket) {
+        while(index > 1) {
+            unsigned parentIndex = index / 2;
+            Slot& parent = slots[parentIndex];
+            Slot& child = slots[index];
+            parent.mutex.lock();
+            child.mutex.lock();
+
+            unsigned next = index;
+            if(parent.tag == availableTag && child.tag == ticket) {
+                if(child.key < parent.key) {
+                    swapSlots(parentIndex, index);
+                    next = parentIndex;
+                } else {
+                    child.tag = availableTag;
+                    next = 0;
+                }
+            } else if(parent.tag == emptyTag) { //A deleteMin moved our element to the root.
+                next = 0;
+            } else if(child.tag != ticket) { //A deleteMin moved our element up.
+                next = parentIndex;
+            }
+
+            child.mutex.unlock();
+            parent.mutex.unlock();
+            if(next == index) { //The parent is being moved up by another thread.
+                std::this_thread::yield();
+            }
+            index = next;
+        }
+
+        if(index == 1) {
+            std::lock_guard<std::mutex> lock(slots[1].mutex);
+            if(slots[1].tag == ticket) {
+                slots[1].tag = availableTag;
+            }
+        }
+    }
+
+    /**
+     * Moves the element at the root, which the caller holds
+     * locked, down until no child is smaller, then unlocks it.
+     */
+    void percolateDown() {
+        unsigned index = 1;
+        while(2*index+1 < slots.size()) {
+            unsigned leftIndex = 2*index;
+            Slot& left = slots[leftIndex];
+            Slot& right = slots[leftIndex+1];
+            left.mutex.lock();
+            right.mutex.lock();
+
+            unsigned childIndex;
+            if(left.tag == emptyTag) { //Slots fill left before right.
+                right.mutex.unlock();
+                left.mutex.unlock();
+                break;
+            } else if(right.tag == emptyTag || left.key < right.key) {
+                right.mutex.unlock();
+                childIndex = leftIndex;
+            } else {
+                left.mutex.unlock();
+                childIndex = leftIndex+1;
+            }
+
+            if(slots[childIndex].key < slots[index].key) {
+                swapSlots(childIndex, index);
+                slots[index].mutex.unlock();
+                index = childIndex;
+            } else {
+                slots[childIndex].mutex.unlock();
+                break;
+            }
+        }
+        slots[index].mutex.unlock();
+    }
+};
+
+#endif  // CONCURRENT_PRIORITY_QUEUE_HPP
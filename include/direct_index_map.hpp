@@ -0,0 +1,143 @@
+#ifndef DIRECT_INDEX_MAP_HPP
+#define DIRECT_INDEX_MAP_HPP
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * Implementation of a map from unsigned integers to instances
+ * of ValueType that stores the value for key k directly in
+ * slot k of a flat array.
+ *
+ * This is meant for keys that are known to lie in a dense range
+ * [0, N) (graph vertex IDs, slot numbers, ...). Every operation
+ * is a single array access; there is no hashing or probing.
+ *
+ * It offers the same insert/get/update/remove interface as
+ * HashTable so it can be used as the position map policy of
+ * PriorityQueue:
+ *
+ *     PriorityQueue<std::string, DirectIndexMap<unsigned>> pq(100);
+ *
+ * Inserting a key outside of the current range grows the array
+ * to fit it, so the range given to the constructor is only a
+ * sizing hint. Memory use is proportional to the largest key,
+ * not to the number of elements: any unsigned key is accepted,
+ * but a key near UINT_MAX needs about 2^32 slots, and if they
+ * cannot be allocated, insert throws std::bad_alloc and leaves
+ * the map as it was.
+ */
+template <typename ValueType>
+class DirectIndexMap
+{
+public:
+    /**
+     * Creates a map that can hold keys in [0, @keyBound)
+     * without growing.
+     */
+    explicit DirectIndexMap(unsigned keyBound) : slots(keyBound), elementCount(0) {};
+
+    /**
+     * Both of these must run in constant time.
+     *
+     * tableSize() is a std::size_t, since the array has 2^32
+     * slots once UINT_MAX is inserted.
+     */
+    std::size_t tableSize() const {
+        return slots.size();
+    };
+
+    unsigned numElements() const {
+        return elementCount;
+    };
+
+    /**
+     * Inserts a key-value pair mapping @key to @value into
+     * the map.
+     *
+     * Returns true if success.
+     * Returns false if @key is already in the map
+     * (in which case, the insertion is not performed).
+     */
+    bool insert(unsigned key, const ValueType& value) {
+        if(key >= slots.size()) {
+            std::size_t newSize = 2*slots.size(); //Neither this nor key+1 wraps around in std::size_t.
+            if(newSize <= key) {
+                newSize = static_cast<std::size_t>(key) + 1;
+            }
+            if(newSize > maxSlots) {
+                newSize = maxSlots;
+            }
+            slots.resize(newSize);
+        } else if(!slots[key].isEmpty) {
+            return false;
+        }
+
+        slots[key].value = value;
+        slots[key].isEmpty = false;
+        elementCount++;
+        return true;
+    };
+
+    /**
+     * Returns the address of the value that @key is mapped to.
+     *
+     * Returns null pointer if @key is not in the map.
+     */
+    ValueType* get(unsigned key) {
+        if(key >= slots.size() || slots[key].isEmpty) {
+            return nullptr;
+        }
+        return &slots[key].value;
+    };
+
+    const ValueType* get(unsigned key) const {
+        if(key >= slots.size() || slots[key].isEmpty) {
+            return nullptr;
+        }
+        return &slots[key].value;
+    };
+
+    /**
+     * Updates the key-value pair with key @key to be
+     * mapped to @newValue.
+     *
+     * Returns true if success.
+     * Returns false if @key is not in the map.
+     */
+    bool update(unsigned key, const ValueType& newValue) {
+        if(key >= slots.size() || slots[key].isEmpty) {
+            return false;
+        }
+        slots[key].value = newValue;
+        return true;
+    };
+
+    /**
+     * Deletes the element that has the given key.
+     *
+     * Returns true if success.
+     * Returns false if @key not found.
+     */
+    bool remove(unsigned key) {
+        if(key >= slots.size() || slots[key].isEmpty) {
+            return false;
+        }
+        slots[key].isEmpty = true;
+        elementCount--;
+        return true;
+    };
+
+private:
+    struct Slot {
+        ValueType value;
+        bool isEmpty = true;
+    };
+
+    static constexpr std::size_t maxSlots = static_cast<std::size_t>(~0u) + 1; //One per unsigned key.
+
+    std::vector<Slot> slots;
+    unsigned elementCount;
+};
+
+#endif  // DIRECT_INDEX_MAP_HPP
@@ -9,6 +9,7 @@ struct Pair {
     unsigned key;
     ValueType value;
     bool isEmpty = true;
+    bool isDeleted = false; //Bucket held an element that was removed.
 };
 
 /**
@@ -20,6 +21,11 @@ struct Pair {
  * Collision resolution: quadratic probing.
  * Non-unique keys are not supported.
  *
+ * Removed buckets are marked as deleted so that lookups can
+ * stop probing at the first bucket that has never been used.
+ * When used and deleted buckets together fill 3/4 of the table,
+ * the table is rebuilt at the same size to clear them out.
+ *
  * The table rehashes whenever the insertion of a new
  * element would put the load factor at at least 1/2.
  * (The rehashing is done before the element would've been inserted.)
@@ -41,7 +47,7 @@ public:
      * Throws std::runtime_error if @tableSize is 0 or not
      * prime.
      */
-    explicit HashTable(unsigned tableSize) : size(tableSize), elementCount(0) {
+    explicit HashTable(unsigned tableSize) : size(tableSize), elementCount(0), deletedCount(0) {
         if(tableSize == 0 || !isPrime(tableSize)) {
             throw std::runtime_error("Table size is <= 0 or not prime!");
         }
@@ -61,11 +67,13 @@ public:
         table = new Pair<ValueType>[rhs.tableSize()];
         size = rhs.tableSize();
         elementCount = rhs.numElements();
+        deletedCount = rhs.deletedCount;
 
         for(unsigned i = 0; i < tableSize(); i++) {
             table[i].key = rhs.table[i].key;
             table[i].value = rhs.table[i].value;
             table[i].isEmpty = rhs.table[i].isEmpty;
+            table[i].isDeleted = rhs.table[i].isDeleted;
         }
     };
 
@@ -78,11 +86,13 @@ public:
         table = new Pair<ValueType>[rhs.tableSize()];
         size = rhs.tableSize();
         elementCount = rhs.numElements();
+        deletedCount = rhs.deletedCount;
         
         for(unsigned i = 0; i < tableSize(); i++) {
             table[i].key = rhs.table[i].key;
             table[i].value = rhs.table[i].value;
             table[i].isEmpty = rhs.table[i].isEmpty;
+            table[i].isDeleted = rhs.table[i].isDeleted;
         }
 
         return *this;
@@ -93,14 +103,16 @@ public:
      * and gives them to "this" object.
      * After this, @rhs should be in a "moved from" state.
      */
-    HashTable(HashTable&& rhs) noexcept : table(nullptr), size(0), elementCount(0) {
+    HashTable(HashTable&& rhs) noexcept : table(nullptr), size(0), elementCount(0), deletedCount(0) {
         table = rhs.table;
         size = rhs.size;
         elementCount = rhs.elementCount;
+        deletedCount = rhs.deletedCount;
 
         rhs.table = nullptr;
         rhs.size = 0;
         rhs.elementCount = 0;
+        rhs.deletedCount = 0;
     };
     HashTable& operator=(HashTable&& rhs) noexcept {
         if(this == &rhs) {
@@ -112,10 +124,12 @@ public:
         table = rhs.table;
         size = rhs.size;
         elementCount = rhs.elementCount;
+        deletedCount = rhs.deletedCount;
 
         rhs.table = nullptr;
         rhs.size = 0;
         rhs.elementCount = 0;
+        rhs.deletedCount = 0;
 
         return *this;
     };
@@ -165,40 +179,33 @@ public:
     bool insert(unsigned key, const ValueType& value) {
         unsigned index = key % tableSize();
         
-        if(table[index].isEmpty) { //Checking for rehash. (This is inefficient, but still "constant".)
-            elementCount++;
-            index = checkRehash(index, key);
-        } else {
-            for(unsigned i = 0; i < tableSize(); i++) {
-                int newIndex = (index + (i*i)) % tableSize();
+        for(unsigned i = 0; i < tableSize(); i++) { //Checking that @key is not in the table yet.
+            int newIndex = (index + (i*i)) % tableSize();
 
-                if(!table[newIndex].isEmpty && key == table[newIndex].key) {
-                    return false;
-                }
+            if(!table[newIndex].isEmpty && key == table[newIndex].key) {
+                return false;
+            }
 
-                if(table[newIndex].isEmpty) {
-                    elementCount++;
-                    index = checkRehash(index, key);
-                    break;                
-                }
+            if(table[newIndex].isEmpty && !table[newIndex].isDeleted) { //Never used, so @key can't be further along.
+                break;
             }
         }
 
-        if(table[index].isEmpty) { //Insert key-value pair if no collison.
-            table[index].key = key;
-            table[index].value = value;
-            table[index].isEmpty = false;
-            return true;
-        } else { //Perform quadratic probing if there is collision.
-            for(unsigned i = 0; i < tableSize(); i++) {
-                int newIndex = (index + (i*i)) % tableSize();
+        elementCount++;
+        index = checkRehash(index, key); //Checking for rehash. (This is inefficient, but still "constant".)
 
-                if(table[newIndex].isEmpty) {
-                    table[newIndex].key = key;
-                    table[newIndex].value = value;
-                    table[newIndex].isEmpty = false;
-                    return true;                    
+        for(unsigned i = 0; i < tableSize(); i++) { //Perform quadratic probing if there is collision.
+            int newIndex = (index + (i*i)) % tableSize();
+
+            if(table[newIndex].isEmpty) {
+                if(table[newIndex].isDeleted) {
+                    table[newIndex].isDeleted = false;
+                    deletedCount--;
                 }
+                table[newIndex].key = key;
+                table[newIndex].value = value;
+                table[newIndex].isEmpty = false;
+                return true;                    
             }
         }
         
@@ -226,6 +233,9 @@ public:
                 if(!table[newIndex].isEmpty && key == table[newIndex].key) {
                     return &table[newIndex].value;
                 }
+                if(table[newIndex].isEmpty && !table[newIndex].isDeleted) {
+                    break;
+                }
             }
         }
         return nullptr;
@@ -242,6 +252,9 @@ public:
                 if(!table[newIndex].isEmpty && key == table[newIndex].key) {
                     return &table[newIndex].value;
                 }
+                if(table[newIndex].isEmpty && !table[newIndex].isDeleted) {
+                    break;
+                }
             }
         }
         return nullptr;
@@ -269,6 +282,9 @@ public:
                     table[newIndex].value = newValue;
                     return true;
                 }
+                if(table[newIndex].isEmpty && !table[newIndex].isDeleted) {
+                    break;
+                }
             }
         }
         return false;
@@ -286,7 +302,9 @@ public:
         unsigned index = key % tableSize();
         if(!table[index].isEmpty && key == table[index].key) {
             table[index].isEmpty = true;
+            table[index].isDeleted = true;
             elementCount--;
+            deletedCount++;
             return true;
         } else { //Quadratic Probing.
             for(unsigned i = 0; i < tableSize(); i++) {
@@ -294,9 +312,14 @@ public:
 
                 if(!table[newIndex].isEmpty && key == table[newIndex].key) {
                     table[newIndex].isEmpty = true;
+                    table[newIndex].isDeleted = true;
                     elementCount--;
+                    deletedCount++;
                     return true;
                 }
+                if(table[newIndex].isEmpty && !table[newIndex].isDeleted) {
+                    break;
+                }
             }
         }
         return false;
@@ -312,7 +335,9 @@ public:
         for(unsigned i = 0; i < tableSize(); i++) {
             if(!table[i].isEmpty && table[i].value == value) {
                 table[i].isEmpty = true;
+                table[i].isDeleted = true;
                 elementCount--;
+                deletedCount++;
                 counter++;
             }
         }
@@ -388,13 +413,14 @@ private:
     Pair<ValueType>* table;
     unsigned size;
     unsigned elementCount;
+    unsigned deletedCount;
 
     bool isPrime(unsigned value) {
         if(value == 1) {
             return false;
         }
 
-        for(unsigned i = 2; i < value; i++) {
+        for(unsigned i = 2; i*i <= value; i++) {
             if(value % i == 0) {
                 return false;
             }
@@ -416,7 +442,7 @@ private:
         double loadFactor = elementCount*1.0 / size;
         unsigned prevElementCount = elementCount - 1;
         
-        if(loadFactor >= 0.5) {
+        if(loadFactor >= 0.5 || 4*(elementCount+deletedCount) >= 3*size) {
             Pair<ValueType>* temp = new Pair<ValueType>[prevElementCount];
             unsigned count = 0;
             for(unsigned i = 0; i < size; i++) {
@@ -427,7 +453,10 @@ private:
                 }
             }
             
-            size = nextPrime((2*size));
+            if(loadFactor >= 0.5) { //Otherwise only the deleted buckets are cleared out.
+                size = nextPrime((2*size));
+            }
+            deletedCount = 0;
             delete[] table;
             table = new Pair<ValueType>[size];
 
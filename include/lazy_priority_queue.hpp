@@ -0,0 +1,433 @@
+#ifndef LAZY_PRIORITY_QUEUE_HPP
+#define LAZY_PRIORITY_QUEUE_HPP
+
+#include "hash_table.hpp"
+#include "direct_index_map.hpp"
+#include "node_pool.hpp"
+
+#include <stdexcept>
+#include <vector>
+
+/**
+ * Implementation of a priority queue with the PriorityQueue
+ * extended API where remove, decreaseKey and increaseKey are lazy,
+ * for workloads that cancel or reschedule most of what they insert.
+ *
+ * The heap holds (key, slot, generation) entries, and each element
+ * lives in a slot (of a NodePool) that carries a generation counter.
+ * Instead of finding an element in the heap and repairing around
+ * it:
+ * - remove bumps the generation of the slot and frees it, which
+ *   makes its heap entry stale. The position map is left as is:
+ *   the id keeps pointing at the freed slot, and lookups check
+ *   that the slot is still in use and holds the id.
+ * - decreaseKey/increaseKey bump the generation and push a new
+ *   entry with the new key; the old entry becomes stale.
+ * Stale entries are dropped when they reach the root, so the root
+ * is always live. Entries never need to know their heap index,
+ * so percolating only moves entries around the heap array.
+ *
+ * Stale entries and ids cost memory until they are cleaned up.
+ * Once the stale entries exceed the compaction ratio (1/2 by
+ * default) of the heap, or the stale ids outnumber the elements,
+ * compact() rebuilds the heap from the live entries with Floyd's
+ * heapify and removes the stale ids from the position map, in
+ * linear time.
+ */
+template <typename ValueType, typename PositionMap = HashTable<unsigned>>
+class LazyPriorityQueue
+{
+public:
+    /**
+     * Creates an empty priority queue.
+     */
+    LazyPriorityQueue() : data(initialMapSize), elementCount(0), staleCount(0), ratioNumerator(1), ratioDenominator(2) {};
+
+    /**
+     * Makes room for @capacity elements, so that inserting up to
+     * that many does not reallocate.
+     */
+    void reserve(unsigned capacity) {
+        slots.reserve(capacity);
+        heap.reserve(capacity);
+    };
+
+    /**
+     * All of these must run in constant time.
+     *
+     * numStale() is the number of stale heap entries.
+     */
+    unsigned numElements() const {
+        return elementCount;
+    };
+
+    unsigned numStale() const {
+        return staleCount;
+    };
+
+    /**
+     * Sets the fraction of stale heap entries, @numerator /
+     * @denominator, above which the heap is compacted.
+     *
+     * Throws std::runtime_error unless 0 < @numerator < @denominator.
+     */
+    void setCompactionRatio(unsigned numerator, unsigned denominator) {
+        if(numerator == 0 || numerator >= denominator) {
+            throw std::runtime_error("Compaction ratio must be in (0, 1)!");
+        }
+        ratioNumerator = numerator;
+        ratioDenominator = denominator;
+    };
+
+    /**
+     * Inserts an element with identity @id and priority @key
+     * holding @value into the priority queue.
+     *
+     * This function runs in logarithmic time.
+     *
+     * Returns true if success.
+     * Returns false if @id is already in the priority queue
+     * (in which case, the insertion is not performed).
+     */
+    bool insert(unsigned id, unsigned key, const ValueType& value) {
+        const unsigned* found = data.get(id);
+        if(found != nullptr && holds(*found, id)) {
+            return false;
+        }
+
+        unsigned slot = slots.allocate();
+        if(found == nullptr) {
+            data.insert(id, slot);
+        } else { //A stale id left by remove().
+            data.update(id, slot);
+        }
+
+        slots[slot].id = id;
+        slots[slot].key = key;
+        slots[slot].value = value;
+        slots[slot].live = true;
+        push(key, slot);
+        elementCount++;
+        return true;
+    };
+
+    /**
+     * Inserts a key-value pair mapping @key to @value, using
+     * @key both as the priority and as the identity of the element.
+     */
+    bool insert(unsigned key, const ValueType& value) {
+        return insert(key, key, value);
+    };
+
+    /**
+     * Returns key, id or value of the smallest element in the
+     * priority queue or null pointer if empty.
+     *
+     * These functions run in constant time.
+     *
+     * The pointer may be invalidated if the priority queue is modified.
+     */
+    const unsigned* getMinKey() const {
+        if(elementCount == 0) {
+            return nullptr;
+        }
+        return &heap[0].key;
+    };
+
+    const unsigned* getMinId() const {
+        if(elementCount == 0) {
+            return nullptr;
+        }
+        return &slots[heap[0].slot].id;
+    };
+
+    const ValueType* getMinValue() const {
+        if(elementCount == 0) {
+            return nullptr;
+        }
+        return &slots[heap[0].slot].value;
+    };
+
+    /**
+     * Removes the root of the priority queue.
+     *
+     * This function runs in logarithmic time, plus dropping the
+     * stale entries that come up to the root.
+     *
+     * Returns true if success.
+     * Returns false if priority queue is empty, i.e. nothing to delete.
+     */
+    bool deleteMin() {
+        if(elementCount == 0) {
+            return false;
+        }
+
+        unsigned slot = heap[0].slot;
+        data.remove(slots[slot].id);
+        kill(slot);
+        popRoot();
+        dropStale();
+        return true;
+    };
+
+    /**
+     * Returns address of the value of the element with identity @id.
+     *
+     * These functions run in "constant time".
+     *
+     * Returns null pointer if @id is not in the priority queue.
+     *
+     * The pointer may be invalidated if an insert grows the slot pool.
+     */
+    ValueType* get(unsigned id) {
+        unsigned slot = find(id);
+        if(slot == none) {
+            return nullptr;
+        }
+        return &slots[slot].value;
+    };
+
+    const ValueType* get(unsigned id) const {
+        unsigned slot = find(id);
+        if(slot == none) {
+            return nullptr;
+        }
+        return &slots[slot].value;
+    };
+
+    /**
+     * Returns address of the priority of the element with identity @id,
+     * or null pointer if @id is not in the priority queue.
+     */
+    const unsigned* getKey(unsigned id) const {
+        unsigned slot = find(id);
+        if(slot == none) {
+            return nullptr;
+        }
+        return &slots[slot].key;
+    };
+
+    /**
+     * Subtracts/adds @change from/to the priority of
+     * the element that has identity @id, by pushing a new heap
+     * entry and leaving the old one stale.
+     *
+     * These functions run in "constant time" + logarithmic time.
+     *
+     * Returns true if success.
+     * Returns false if any of the following:
+     * - @change is 0.
+     * - @id not found.
+     *
+     * As in PriorityQueue, overflow/underflow has an undefined effect.
+     */
+    bool decreaseKey(unsigned id, unsigned change) {
+        unsigned slot = find(id);
+        if(change == 0 || slot == none) {
+            return false;
+        }
+
+        rekey(slot, slots[slot].key - change);
+        return true;
+    };
+
+    bool increaseKey(unsigned id, unsigned change) {
+        unsigned slot = find(id);
+        if(change == 0 || slot == none) {
+            return false;
+        }
+
+        rekey(slot, slots[slot].key + change);
+        return true;
+    };
+
+    /**
+     * Removes element that has identity @id, leaving its heap
+     * entry and its id in the position map stale.
+     *
+     * This function runs in "constant time", plus dropping stale
+     * entries if the element was the smallest one, plus the
+     * occasional compaction.
+     *
+     * Returns true if success.
+     * Returns false if @id not found.
+     */
+    bool remove(unsigned id) {
+        unsigned slot = find(id);
+        if(slot == none) {
+            return false;
+        }
+
+        kill(slot);
+        staleCount++;
+        staleIds.push_back(id);
+        dropStale();
+        checkCompact();
+        return true;
+    };
+
+    /**
+     * Drops every stale heap entry and stale id now.
+     *
+     * This function runs in linear time.
+     */
+    void compact() {
+        unsigned live = 0;
+        for(unsigned i = 0; i < heap.size(); i++) {
+            if(isLive(heap[i])) {
+                heap[live++] = heap[i];
+            }
+        }
+        heap.resize(live);
+        staleCount = 0;
+        if(heap.size() > 1) {
+            for(unsigned i = parent(heap.size()-1) + 1; i-- > 0; ) {
+                percolateDown(i);
+            }
+        }
+
+        for(unsigned i = 0; i < staleIds.size(); i++) {
+            const unsigned* found = data.get(staleIds[i]);
+            if(found != nullptr && !holds(*found, staleIds[i])) { //Not inserted again since.
+                data.remove(staleIds[i]);
+            }
+        }
+        staleIds.clear();
+    };
+
+private:
+    struct Slot {
+        unsigned id;
+        unsigned key;
+        ValueType value;
+        unsigned generation = 0;
+        bool live = false;
+        unsigned next; //Next free slot.
+    };
+
+    struct Entry {
+        unsigned key;
+        unsigned slot;
+        unsigned generation; //Stale once the slot's generation moves on.
+    };
+
+    static constexpr unsigned none = ~0u;
+    static constexpr unsigned initialMapSize = 11;
+
+    NodePool<Slot, &Slot::next> slots;
+    std::vector<Entry> heap; //0-based binary heap.
+    std::vector<unsigned> staleIds; //Ids removed from the queue but not from the position map.
+    PositionMap data;
+    unsigned elementCount;
+    unsigned staleCount;
+    unsigned ratioNumerator;
+    unsigned ratioDenominator;
+
+    /**
+     * Takes the element out of @slot and frees the slot. Its heap
+     * entry is stale from now on.
+     */
+    void kill(unsigned slot) {
+        slots[slot].live = false;
+        slots[slot].generation++;
+        slots.release(slot);
+        elementCount--;
+    }
+
+    bool holds(unsigned slot, unsigned id) const {
+        return slots[slot].live && slots[slot].id == id;
+    }
+
+    bool isLive(const Entry& entry) const {
+        return slots[entry.slot].generation == entry.generation;
+    }
+
+    /**
+     * Returns the slot of @id, or none if @id is not in the queue.
+     */
+    unsigned find(unsigned id) const {
+        const unsigned* found = data.get(id);
+        if(found == nullptr || !holds(*found, id)) {
+            return none;
+        }
+        return *found;
+    }
+
+    void push(unsigned key, unsigned slot) {
+        heap.push_back(Entry{key, slot, slots[slot].generation});
+        percolateUp(heap.size()-1);
+    }
+
+    /**
+     * Gives @slot the priority @key with a new heap entry.
+     */
+    void rekey(unsigned slot, unsigned key) {
+        slots[slot].key = key;
+        slots[slot].generation++;
+        staleCount++;
+        push(key, slot);
+        dropStale();
+        checkCompact();
+    }
+
+    void popRoot() {
+        heap[0] = heap.back();
+        heap.pop_back();
+        if(!heap.empty()) {
+            percolateDown(0);
+        }
+    }
+
+    /**
+     * Pops stale entries off the root until it is live.
+     */
+    void dropStale() {
+        while(!heap.empty() && !isLive(heap[0])) {
+            popRoot();
+            staleCount--;
+        }
+    }
+
+    void checkCompact() {
+        if(static_cast<unsigned long long>(staleCount) * ratioDenominator > static_cast<unsigned long long>(heap.size()) * ratioNumerator
+           || staleIds.size() > elementCount + initialMapSize) {
+            compact();
+        }
+    }
+
+    unsigned parent(unsigned index) const {
+        return (index-1) / 2;
+    }
+
+    /**
+     * Both percolate functions carry the entry at @index in a
+     * "hole", as in PriorityQueue.
+     */
+    void percolateUp(unsigned index) {
+        Entry entry = heap[index];
+        while(index > 0 && heap[parent(index)].key > entry.key) {
+            heap[index] = heap[parent(index)];
+            index = parent(index);
+        }
+        heap[index] = entry;
+    }
+
+    void percolateDown(unsigned index) {
+        Entry entry = heap[index];
+        unsigned count = heap.size();
+        while(2*index+1 < count) {
+            unsigned child = 2*index+1;
+            if(child+1 < count && heap[child+1].key < heap[child].key) {
+                child++;
+            }
+            if(heap[child].key >= entry.key) {
+                break;
+            }
+            heap[index] = heap[child];
+            index = child;
+        }
+        heap[index] = entry;
+    }
+};
+
+#endif  // LAZY_PRIORITY_QUEUE_HPP
@@ -0,0 +1,171 @@
+#ifndef MULTI_QUEUE_HPP
+#define MULTI_QUEUE_HPP
+
+#include "priority_queue.hpp"
+#include "thread_random.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * Implementation of a relaxed concurrent priority queue in the
+ * MultiQueue style (Rihani, Sanders and Dementiev, 2015).
+ *
+ * The queue is made of c*P ordinary PriorityQueues ("shards"),
+ * for P threads and a factor c, each guarded by its own mutex.
+ * insert puts the element into a random shard. deleteMin looks
+ * at the cached minimum key of two random shards without
+ * locking, try-locks the one with the smaller key, and removes
+ * its minimum. If a lock is taken, other random shards are tried
+ * instead of waiting.
+ *
+ * The order is only approximate: deleteMin returns one of the
+ * smallest elements but not necessarily the smallest, and the
+ * expected rank of what it returns grows with the number of
+ * shards. In exchange, threads rarely touch the same shard, so
+ * throughput scales with the number of threads.
+ *
+ * Ids are only checked for uniqueness within a shard; callers
+ * should not insert the same id twice. All member functions are
+ * safe to call from several threads at once.
+ */
+template <typename ValueType, typename PositionMap = HashTable<unsigned>>
+class MultiQueue
+{
+public:
+    /**
+     * Creates a multiqueue with @factor shards for each of
+     * @threads threads.
+     */
+    explicit MultiQueue(unsigned threads, unsigned factor = 2) : shards(threads*factor), elementCount(0) {
+        if(threads == 0 || factor == 0) {
+            throw std::runtime_error("threads and factor cannot be <= 0!");
+        }
+    };
+
+    MultiQueue(const MultiQueue& rhs) = delete;
+    MultiQueue& operator=(const MultiQueue& rhs) = delete;
+
+    /**
+     * Returns the number of elements. It is exact when no other
+     * thread is modifying the queue.
+     */
+    unsigned numElements() const {
+        return elementCount.load(std::memory_order_relaxed);
+    };
+
+    unsigned numShards() const {
+        return shards.size();
+    };
+
+    /**
+     * Inserts an element with identity @id and priority @key
+     * holding @value into a random shard.
+     *
+     * Returns true if success.
+     * Returns false if @id is already in the shard that was picked
+     * (in which case, the insertion is not performed).
+     */
+    bool insert(unsigned id, unsigned key, const ValueType& value) {
+        while(true) {
+            Shard& shard = shards[randomShard()];
+            std::unique_lock<std::mutex> lock(shard.mutex, std::try_to_lock);
+            if(!lock.owns_lock()) {
+                continue;
+            }
+
+            if(!shard.queue.insert(id, key, value)) {
+                return false;
+            }
+            shard.updateMin();
+            elementCount.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    };
+
+    /**
+     * Inserts a key-value pair mapping @key to @value, using
+     * @key both as the priority and as the identity of the element.
+     */
+    bool insert(unsigned key, const ValueType& value) {
+        return insert(key, key, value);
+    };
+
+    /**
+     * Removes one of the smallest elements and writes it to @out.
+     *
+     * Returns true if success.
+     * Returns false if every shard was empty, i.e. nothing to delete.
+     */
+    bool deleteMin(Element<ValueType>& out) {
+        for(unsigned attempt = 0; attempt < 2*shards.size(); attempt++) {
+            unsigned a = randomShard();
+            unsigned b = randomShard();
+            if(shards[b].min.load(std::memory_order_relaxed) < shards[a].min.load(std::memory_order_relaxed)) {
+                a = b;
+            }
+            if(shards[a].min.load(std::memory_order_relaxed) == empty) {
+                continue;
+            }
+            if(popFrom(shards[a], out)) {
+                return true;
+            }
+        }
+
+        //The queue looks empty (or is very contended): check every shard.
+        for(unsigned i = 0; i < shards.size(); i++) {
+            if(popFrom(shards[i], out, true)) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+private:
+    static constexpr unsigned long long empty = 1ull << 32; //Larger than any key.
+
+    struct alignas(64) Shard {
+        std::mutex mutex;
+        PriorityQueue<ValueType, PositionMap> queue;
+        std::atomic<unsigned long long> min{empty}; //Minimum key, read without the lock.
+
+        void updateMin() {
+            const unsigned* key = queue.getMinKey();
+            min.store(key == nullptr ? empty : *key, std::memory_order_relaxed);
+        }
+    };
+
+    std::vector<Shard> shards;
+    std::atomic<unsigned> elementCount;
+
+    /**
+     * Removes the minimum of @shard if it can be locked (or always,
+     * if @wait) and the shard is not empty.
+     */
+    bool popFrom(Shard& shard, Element<ValueType>& out, bool wait = false) {
+        std::unique_lock<std::mutex> lock(shard.mutex, std::defer_lock);
+        if(wait) {
+            lock.lock();
+        } else if(!lock.try_lock()) {
+            return false;
+        }
+
+        if(shard.queue.deleteMinBatch(1, &out) == 0) {
+            return false;
+        }
+        shard.updateMin();
+        elementCount.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * Returns a random shard index (see thread_random.hpp).
+     */
+    unsigned randomShard() const {
+        return threadRandom() % shards.size();
+    }
+};
+
+#endif  // MULTI_QUEUE_HPP
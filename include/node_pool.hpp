@@ -0,0 +1,119 @@
+#ifndef NODE_POOL_HPP
+#define NODE_POOL_HPP
+
+#include <utility>
+#include <vector>
+
+/**
+ * A pool of nodes kept in one vector, for the queues that are
+ * built out of linked nodes rather than an array heap.
+ *
+ * Nodes refer to each other by their index in the pool, so
+ * growing the vector does not break the links, and the nodes are
+ * contiguous in memory. A released node goes on a free list,
+ * chained through the member of Node named by Next (a link that
+ * a free node has no other use for), and is handed out again by
+ * the next allocate().
+ *
+ * References to nodes are invalidated when allocate() grows the
+ * vector; indices are not.
+ */
+template <typename Node, unsigned Node::*Next>
+class NodePool
+{
+public:
+    static constexpr unsigned none = ~0u;
+
+    NodePool() : freeList(none) {};
+
+    /**
+     * Returns the index of a free node, reusing a released one if
+     * there is one. The members of a reused node keep whatever
+     * they held.
+     *
+     * This function runs in constant time (amortized over the
+     * growth of the vector).
+     */
+    unsigned allocate() {
+        unsigned node;
+        if(freeList != none) {
+            node = freeList;
+            freeList = nodes[node].*Next;
+        } else {
+            node = nodes.size();
+            nodes.emplace_back();
+        }
+        return node;
+    };
+
+    /**
+     * Puts @node on the free list.
+     */
+    void release(unsigned node) {
+        nodes[node].*Next = freeList;
+        freeList = node;
+    };
+
+    Node& operator[](unsigned node) {
+        return nodes[node];
+    };
+
+    const Node& operator[](unsigned node) const {
+        return nodes[node];
+    };
+
+    /**
+     * Returns the number of nodes, free ones included.
+     */
+    unsigned size() const {
+        return nodes.size();
+    };
+
+    /**
+     * Makes room for @capacity nodes, so that allocating up to
+     * that many does not reallocate.
+     */
+    void reserve(unsigned capacity) {
+        nodes.reserve(capacity);
+    };
+
+    /**
+     * Frees every node at once.
+     */
+    void clear() {
+        nodes.clear();
+        freeList = none;
+    };
+
+    /**
+     * Exchanges the nodes of this pool and @rhs.
+     */
+    void swap(NodePool& rhs) {
+        std::swap(nodes, rhs.nodes);
+        std::swap(freeList, rhs.freeList);
+    };
+
+private:
+    std::vector<Node> nodes;
+    unsigned freeList; //Free nodes, chained through their Next member.
+};
+
+/**
+ * Returns the index of the lowest set bit of @mask, for finding
+ * the first non-empty bucket or slot from a bitmap. @mask must
+ * not be 0.
+ */
+inline unsigned lowestBit(unsigned long long mask)
+{
+#if defined(__GNUC__)
+    return __builtin_ctzll(mask);
+#else
+    unsigned bit = 0;
+    for(; (mask & 1) == 0; mask >>= 1) {
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+#endif  // NODE_POOL_HPP
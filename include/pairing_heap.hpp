@@ -0,0 +1,458 @@
+#ifndef PAIRING_HEAP_HPP
+#define PAIRING_HEAP_HPP
+
+#include "hash_table.hpp"
+#include "direct_index_map.hpp"
+#include "node_pool.hpp"
+
+#include <utility>
+#include <vector>
+
+/**
+ * Implementation of a pairing heap with the same extended API
+ * as PriorityQueue: elements have an unsigned id and an unsigned
+ * priority (the key), and the position map (HashTable<unsigned>
+ * by default, or DirectIndexMap<unsigned> for small dense ids)
+ * maps each id to its node.
+ *
+ * Nodes live in a NodePool (see node_pool.hpp) rather than
+ * being allocated one by one, and refer to each other by index.
+ * Each node points to its leftmost child, its right sibling, and
+ * "prev", which is its left sibling or, for a leftmost child,
+ * its parent.
+ *
+ * insert and decreaseKey are O(1): they link a single node or
+ * subtree with the root. deleteMin, increaseKey and remove are
+ * O(log n) amortized and combine the children of the removed
+ * node with the usual two-pass pairing. The heap grows as
+ * needed; there is no max size.
+ */
+template <typename ValueType, typename PositionMap = HashTable<unsigned>>
+class PairingHeap
+{
+public:
+    /**
+     * Creates an empty pairing heap.
+     */
+    PairingHeap() : data(initialMapSize), root(none), elementCount(0) {};
+
+    /**
+     * Makes room for @capacity nodes, so that inserting up to
+     * that many elements does not reallocate the node pool.
+     */
+    void reserve(unsigned capacity) {
+        nodes.reserve(capacity);
+    };
+
+    /**
+     * Must run in constant time.
+     */
+    unsigned numElements() const {
+        return elementCount;
+    };
+
+    /**
+     * Inserts an element with identity @id and priority @key
+     * holding @value into the heap.
+     *
+     * This function runs in constant time (amortized over the
+     * growth of the node pool).
+     *
+     * Returns true if success.
+     * Returns false if @id is already in the heap
+     * (in which case, the insertion is not performed).
+     */
+    bool insert(unsigned id, unsigned key, const ValueType& value) {
+        unsigned node = allocate();
+        if(!data.insert(id, node)) {
+            nodes.release(node);
+            return false;
+        }
+
+        nodes[node].id = id;
+        nodes[node].key = key;
+        nodes[node].value = value;
+
+        root = (root == none) ? node : link(root, node);
+        elementCount++;
+        return true;
+    };
+
+    /**
+     * Inserts a key-value pair mapping @key to @value, using
+     * @key both as the priority and as the identity of the element.
+     */
+    bool insert(unsigned key, const ValueType& value) {
+        return insert(key, key, value);
+    };
+
+    /**
+     * Returns key, id or value of the smallest element in the
+     * heap or null pointer if empty.
+     *
+     * These functions run in constant time.
+     *
+     * The pointer may be invalidated if the heap is modified.
+     */
+    const unsigned* getMinKey() const {
+        if(root == none) {
+            return nullptr;
+        }
+        return &nodes[root].key;
+    };
+
+    const unsigned* getMinId() const {
+        if(root == none) {
+            return nullptr;
+        }
+        return &nodes[root].id;
+    };
+
+    const ValueType* getMinValue() const {
+        if(root == none) {
+            return nullptr;
+        }
+        return &nodes[root].value;
+    };
+
+    /**
+     * Removes the root of the heap.
+     *
+     * This function runs in O(log n) amortized time.
+     *
+     * Returns true if success.
+     * Returns false if heap is empty, i.e. nothing to delete.
+     */
+    bool deleteMin() {
+        if(root == none) {
+            return false;
+        }
+
+        data.remove(nodes[root].id);
+        removeNode(root);
+        return true;
+    };
+
+    /**
+     * Returns address of the value of the element with identity @id.
+     *
+     * These functions run in "constant time".
+     *
+     * Returns null pointer if @id is not in the heap.
+     *
+     * The pointer may be invalidated if an insert grows the node
+     * pool, and by merge().
+     */
+    ValueType* get(unsigned id) {
+        const unsigned* node = data.get(id);
+        if(node == nullptr) {
+            return nullptr;
+        }
+        return &nodes[*node].value;
+    };
+
+    const ValueType* get(unsigned id) const {
+        const unsigned* node = data.get(id);
+        if(node == nullptr) {
+            return nullptr;
+        }
+        return &nodes[*node].value;
+    };
+
+    /**
+     * Returns address of the priority of the element with identity @id,
+     * or null pointer if @id is not in the heap.
+     */
+    const unsigned* getKey(unsigned id) const {
+        const unsigned* node = data.get(id);
+        if(node == nullptr) {
+            return nullptr;
+        }
+        return &nodes[*node].key;
+    };
+
+    /**
+     * Subtracts/adds @change from/to the priority of
+     * the element that has identity @id.
+     *
+     * decreaseKey runs in "constant time": the node's subtree is
+     * cut out and linked with the root. increaseKey detaches the
+     * node, pairs up its children, and links both back with the
+     * root, in O(log n) amortized time.
+     *
+     * Returns true if success.
+     * Returns false if any of the following:
+     * - @change is 0.
+     * - @id not found.
+     *
+     * The function does not do anything about overflow/underflow.
+     */
+    bool decreaseKey(unsigned id, unsigned change) {
+        const unsigned* found = data.get(id);
+        if(change == 0 || found == nullptr) {
+            return false;
+        }
+
+        unsigned node = *found;
+        nodes[node].key -= change;
+        if(node != root) {
+            cut(node);
+            root = link(root, node);
+        }
+        return true;
+    };
+
+    bool increaseKey(unsigned id, unsigned change) {
+        const unsigned* found = data.get(id);
+        if(change == 0 || found == nullptr) {
+            return false;
+        }
+
+        unsigned node = *found;
+        nodes[node].key += change;
+
+        unsigned children = combineChildren(node);
+        nodes[node].child = none;
+        if(node == root) {
+            root = (children == none) ? node : link(node, children);
+        } else {
+            cut(node);
+            if(children != none) {
+                root = link(root, children);
+            }
+            root = link(root, node);
+        }
+        return true;
+    };
+
+    /**
+     * Removes element that has identity @id.
+     *
+     * This function runs in O(log n) amortized time.
+     *
+     * Returns true if success.
+     * Returns false if @id not found.
+     */
+    bool remove(unsigned id) {
+        const unsigned* found = data.get(id);
+        if(found == nullptr) {
+            return false;
+        }
+
+        unsigned node = *found;
+        data.remove(id);
+        removeNode(node);
+        return true;
+    };
+
+    /**
+     * Moves every element of @rhs into this heap, leaving @rhs
+     * empty.
+     *
+     * The node pools are separate, so the nodes of the smaller
+     * heap are copied into the pool of the larger one (keeping
+     * the tree shape), and the two roots are then linked with a
+     * single comparison. This takes time linear in the size of
+     * the smaller heap and does no other heap work.
+     *
+     * Returns true if success.
+     * Returns false if an id is in both heaps (in which case,
+     * nothing is moved).
+     */
+    bool merge(PairingHeap&& rhs) {
+        if(this == &rhs || rhs.root == none) {
+            return true;
+        }
+        bool swapped = rhs.elementCount > elementCount;
+        if(swapped) { //Copy the smaller heap into the larger one.
+            swap(rhs);
+            if(rhs.root == none) {
+                return true;
+            }
+        }
+        for(unsigned node = 0; node < rhs.nodes.size(); node++) { //Looking for shared ids.
+            const unsigned* found = rhs.data.get(rhs.nodes[node].id);
+            if(found != nullptr && *found == node && data.get(rhs.nodes[node].id) != nullptr) {
+                if(swapped) { //Give both heaps back their own elements.
+                    swap(rhs);
+                }
+                return false;
+            }
+        }
+
+        std::vector<unsigned> moved(rhs.nodes.size(), none); //rhs node -> node in this pool.
+        rhs.pairs.clear();
+        rhs.pairs.push_back(rhs.root);
+        while(!rhs.pairs.empty()) { //Allocate a node for every rhs node.
+            unsigned old = rhs.pairs.back();
+            rhs.pairs.pop_back();
+
+            unsigned node = allocate();
+            moved[old] = node;
+            nodes[node].id = rhs.nodes[old].id;
+            nodes[node].key = rhs.nodes[old].key;
+            nodes[node].value = std::move(rhs.nodes[old].value);
+            data.insert(nodes[node].id, node);
+
+            for(unsigned c = rhs.nodes[old].child; c != none; c = rhs.nodes[c].sibling) {
+                rhs.pairs.push_back(c);
+            }
+        }
+
+        for(unsigned old = 0; old < moved.size(); old++) { //Translate the links.
+            unsigned node = moved[old];
+            if(node != none) {
+                nodes[node].child = translate(moved, rhs.nodes[old].child);
+                nodes[node].sibling = translate(moved, rhs.nodes[old].sibling);
+                nodes[node].prev = translate(moved, rhs.nodes[old].prev);
+            }
+        }
+
+        unsigned other = moved[rhs.root];
+        elementCount += rhs.elementCount;
+        root = (root == none) ? other : link(root, other);
+
+        rhs.nodes.clear();
+        rhs.data = PositionMap(initialMapSize);
+        rhs.root = none;
+        rhs.elementCount = 0;
+        return true;
+    };
+
+    /**
+     * Exchanges the contents of this heap and @rhs.
+     */
+    void swap(PairingHeap& rhs) {
+        nodes.swap(rhs.nodes);
+        std::swap(data, rhs.data);
+        std::swap(root, rhs.root);
+        std::swap(elementCount, rhs.elementCount);
+    };
+
+private:
+    struct Node {
+        unsigned id;
+        unsigned key;
+        ValueType value;
+        unsigned child;
+        unsigned sibling;
+        unsigned prev;
+    };
+
+    static constexpr unsigned none = ~0u;
+    static constexpr unsigned initialMapSize = 11;
+
+    NodePool<Node, &Node::sibling> nodes;
+    std::vector<unsigned> pairs; //Scratch space for combineChildren.
+    PositionMap data;
+    unsigned root;
+    unsigned elementCount;
+
+    unsigned allocate() {
+        unsigned node = nodes.allocate();
+        nodes[node].child = none;
+        nodes[node].sibling = none;
+        nodes[node].prev = none;
+        return node;
+    }
+
+    static unsigned translate(const std::vector<unsigned>& moved, unsigned node) {
+        return (node == none) ? none : moved[node];
+    }
+
+    /**
+     * Unlinks @node from the heap and frees it, without touching
+     * the position map.
+     */
+    void removeNode(unsigned node) {
+        unsigned children = combineChildren(node);
+        if(node == root) {
+            root = children;
+        } else {
+            cut(node);
+            if(children != none) {
+                root = link(root, children);
+            }
+        }
+        nodes.release(node);
+        elementCount--;
+    }
+
+    /**
+     * Links two trees (roots @a and @b, without siblings) and
+     * returns the root of the result: the root with the larger
+     * key becomes the leftmost child of the other.
+     */
+    unsigned link(unsigned a, unsigned b) {
+        if(nodes[b].key < nodes[a].key) {
+            std::swap(a, b);
+        }
+
+        nodes[b].prev = a;
+        nodes[b].sibling = nodes[a].child;
+        if(nodes[a].child != none) {
+            nodes[nodes[a].child].prev = b;
+        }
+        nodes[a].child = b;
+        nodes[a].sibling = none;
+        nodes[a].prev = none;
+        return a;
+    }
+
+    /**
+     * Detaches the subtree rooted at @node (not the root) from
+     * its parent and siblings.
+     */
+    void cut(unsigned node) {
+        unsigned prev = nodes[node].prev;
+        unsigned sibling = nodes[node].sibling;
+
+        if(nodes[prev].child == node) { //Leftmost child, prev is the parent.
+            nodes[prev].child = sibling;
+        } else {
+            nodes[prev].sibling = sibling;
+        }
+        if(sibling != none) {
+            nodes[sibling].prev = prev;
+        }
+
+        nodes[node].sibling = none;
+        nodes[node].prev = none;
+    }
+
+    /**
+     * Combines the children of @node into a single tree with
+     * two-pass pairing and returns its root (or none if @node
+     * has no children). @node's child list is left dangling.
+     */
+    unsigned combineChildren(unsigned node) {
+        pairs.clear();
+
+        unsigned current = nodes[node].child;
+        while(current != none) { //First pass: link children in pairs, left to right.
+            unsigned a = current;
+            unsigned b = nodes[a].sibling;
+            if(b == none) {
+                nodes[a].prev = none;
+                pairs.push_back(a);
+                break;
+            }
+            current = nodes[b].sibling;
+            nodes[a].sibling = none;
+            nodes[b].sibling = none;
+            pairs.push_back(link(a, b));
+        }
+
+        if(pairs.empty()) {
+            return none;
+        }
+
+        unsigned result = pairs.back();
+        for(unsigned i = pairs.size()-1; i > 0; i--) { //Second pass: link right to left.
+            result = link(pairs[i-1], result);
+        }
+        return result;
+    }
+};
+
+#endif  // PAIRING_HEAP_HPP
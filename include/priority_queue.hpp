@@ -2,44 +2,158 @@
 #define PRIORITY_QUEUE_HPP
 
 #include "hash_table.hpp"
+#include "direct_index_map.hpp"
+#include "simd_min.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/**
+ * An element of a priority queue: @id identifies it for the
+ * extended API, @key is its priority. Used to pass elements in
+ * bulk, e.g. to PriorityQueue::assign().
+ */
+template <typename ValueType, typename KeyType = unsigned>
+struct Element {
+    unsigned id;
+    KeyType key;
+    ValueType value;
+};
 
 /**
  * Implementation of a priority queue that supports the
- * extended API. This priority queue maps unsigned values 
- * to instances of ValueType. Hash table is used to support
+ * extended API. This priority queue orders instances of
+ * ValueType by an unsigned priority (the key) and identifies
+ * them by a separate unsigned id. Hash table is used to support
  * operations of the extended API.
+ *
+ * The heap itself only holds (key, handle) entries, stored as
+ * two parallel arrays. Each handle names a slot in a side array
+ * that holds the element's id, value and current heap index.
+ * Percolating moves 8 bytes per level and records the new heap
+ * index in the slot, and percolating never moves a slot, so
+ * pointers returned by get() stay valid across heap
+ * reorganization. They are invalidated when the element is
+ * removed or when the storage is resized: reserve(), and, in a
+ * growable queue, an insert, insertBatch() or merge() that needs
+ * more room or an auto-shrink (see setAutoShrink()).
+ *
+ * PositionMap is the map from id to handle that the extended
+ * API relies on. It defaults to HashTable<unsigned>. When ids
+ * are known to be small and dense (e.g. graph vertex IDs),
+ * DirectIndexMap<unsigned> turns every lookup into a single
+ * array access.
+ *
+ * Arity is the number of children per heap node. The default
+ * of 2 is a binary heap. A 4-ary or 8-ary heap is shallower,
+ * which makes insert and decreaseKey cheaper and keeps the
+ * children scanned by percolateDown next to each other in memory.
+ * The key array is 64-byte aligned and offset so that the first
+ * child of every node starts a cache line whenever Arity keys
+ * fill a whole number of lines (e.g. 16 unsigned keys), and
+ * otherwise never straddle one as long as they fit in a line
+ * and evenly divide it (e.g. 4 or 8 unsigned keys).
+ * When Arity is a multiple of 4, percolateDown picks the smallest
+ * child with SSE4.1/AVX2 vector min (see simd_min.hpp) whenever
+ * the node has all Arity children.
+ *
+ * A queue built with PriorityQueue(maxSize) has a fixed capacity
+ * and insert fails once it is full. A queue built with the default
+ * constructor is growable: its capacity doubles whenever an insert
+ * would exceed it (amortized O(1) extra per insert), and with
+ * setAutoShrink(true) it halves once occupancy drops below 1/4.
+ * reserve() preallocates in either mode.
+ *
+ * A whole range of elements can be loaded at once with assign()
+ * or the range constructor, which run Floyd's bottom-up heapify
+ * in O(n) instead of n inserts in O(n log n).
+ *
+ * KeyType and Compare set the priority order. Compare(a, b) is
+ * true when key a comes out before key b, so the default
+ * std::less<unsigned> is a min-heap on unsigned keys, and e.g.
+ * std::greater<unsigned> gives a max-heap, std::less<double>
+ * floating-point deadlines and std::less<std::pair<...>>
+ * lexicographic priorities. The queue keeps its own Compare
+ * object, which can be passed to the constructors, so the order
+ * may carry state or be a lambda. Compare is a type rather than a
+ * function pointer, so comparisons are inlined. "Smallest" and
+ * "min" below mean first in this order. The SIMD child search is
+ * only used for the default order on unsigned keys.
  */
-template <typename ValueType>
+template <typename ValueType, typename PositionMap = HashTable<unsigned>, unsigned Arity = 2,
+          typename KeyType = unsigned, typename Compare = std::less<KeyType>>
 class PriorityQueue
 {
+    static_assert(Arity >= 2, "PriorityQueue arity must be at least 2");
+
 public:
     /**
-     * Creates a priority queue that can have at most @maxSize elements.
+     * Creates a priority queue that can have at most @maxSize elements,
+     * ordered by @comp.
      *
      * Throws std::runtime_error if @maxSize is 0.
      */
-    explicit PriorityQueue(unsigned maxSize) : data(nextPrime(maxSize)), size(maxSize), elementCount(0) {
+    explicit PriorityQueue(unsigned maxSize, const Compare& comp = Compare()) : data(nextPrime(maxSize)), size(maxSize), elementCount(0), growable(false), autoShrink(false), comp(comp) {
         if(maxSize == 0) {
             throw std::runtime_error("maxSize cannot be <= 0!");
         }
 
-        heap = new Pair<ValueType>[maxSize+1];
+        keys = allocateKeys(maxSize+1);
+        handles = new unsigned[maxSize+1];
+        slots = new Slot[maxSize];
+
+        for(unsigned i = 1; i <= maxSize; i++) { //Every handle starts out free.
+            handles[i] = i-1;
+        }
+    };
+
+    /**
+     * Creates a growable priority queue, with no limit on the
+     * number of elements other than memory.
+     */
+    PriorityQueue() : PriorityQueue(Compare()) {};
+
+    /**
+     * Creates a growable priority queue ordered by @comp.
+     */
+    explicit PriorityQueue(const Compare& comp) : PriorityQueue(initialCapacity, comp) {
+        growable = true;
+    };
+
+    /**
+     * Creates a growable priority queue, ordered by @comp, holding
+     * the elements of [@first, @last), built in linear time (see
+     * assign()).
+     *
+     * Throws std::runtime_error if two elements share an id.
+     */
+    template <typename ForwardIt>
+    PriorityQueue(ForwardIt first, ForwardIt last, const Compare& comp = Compare()) : PriorityQueue(comp) {
+        if(!assign(first, last)) {
+            throw std::runtime_error("Range contains duplicate ids!");
+        }
     };
 
     ~PriorityQueue() {
-        delete[] heap;
+        freeKeys(keys, size+1);
+        delete[] handles;
+        delete[] slots;
     };
 
     /**
      * Makes the underlying implementation details (including the max size) look
      * exactly the same as that of @rhs.
      */
-    PriorityQueue(const PriorityQueue& rhs) : data(rhs.data), size(rhs.maxSize()), elementCount(rhs.elementCount) {
-        heap = new Pair<ValueType>[rhs.maxSize()+1];
-        
-        for(unsigned i = 0; i < rhs.maxSize()+1; i++) {
-            heap[i] = rhs.heap[i];
-        }
+    PriorityQueue(const PriorityQueue& rhs) : data(rhs.data), size(rhs.maxSize()), elementCount(rhs.elementCount), growable(rhs.growable), autoShrink(rhs.autoShrink), comp(rhs.comp) {
+        keys = allocateKeys(rhs.maxSize()+1);
+        handles = new unsigned[rhs.maxSize()+1];
+        slots = new Slot[rhs.maxSize()];
+        copyArrays(rhs);
     };
 
     PriorityQueue& operator=(const PriorityQueue& rhs) {
@@ -47,14 +161,19 @@ public:
 			return *this;
 		}
 
-        delete[] heap;
-        heap = new Pair<ValueType>[rhs.maxSize()+1];
+        freeKeys(keys, size+1);
+        delete[] handles;
+        delete[] slots;
+        keys = allocateKeys(rhs.maxSize()+1);
+        handles = new unsigned[rhs.maxSize()+1];
+        slots = new Slot[rhs.maxSize()];
         data = rhs.data;
+        size = rhs.size;
         elementCount = rhs.elementCount;
-
-        for(unsigned i = 0; i < rhs.maxSize()+1; i++) {
-            heap[i] = rhs.heap[i];
-        }
+        growable = rhs.growable;
+        autoShrink = rhs.autoShrink;
+        comp = rhs.comp;
+        copyArrays(rhs);
 
         return *this;
     };
@@ -64,12 +183,18 @@ public:
      * and gives them to "this" object.
      * After this, @rhs should be in a "moved from" state.
      */
-    PriorityQueue(PriorityQueue&& rhs) noexcept : data(std::move(rhs.data)) {
-        heap = rhs.heap;
+    PriorityQueue(PriorityQueue&& rhs) noexcept : data(std::move(rhs.data)), comp(rhs.comp) {
+        keys = rhs.keys;
+        handles = rhs.handles;
+        slots = rhs.slots;
         size = rhs.size;
         elementCount = rhs.elementCount;
+        growable = rhs.growable;
+        autoShrink = rhs.autoShrink;
 
-        rhs.heap = nullptr;
+        rhs.keys = nullptr;
+        rhs.handles = nullptr;
+        rhs.slots = nullptr;
         rhs.size = 0;
         rhs.elementCount = 0;
     };
@@ -79,23 +204,34 @@ public:
 			return *this;
 		}
 
-        delete[] heap;
+        freeKeys(keys, size+1);
+        delete[] handles;
+        delete[] slots;
 
-        heap = rhs.heap;
+        keys = rhs.keys;
+        handles = rhs.handles;
+        slots = rhs.slots;
         size = rhs.size;
         elementCount = rhs.elementCount;
+        growable = rhs.growable;
+        autoShrink = rhs.autoShrink;
+        comp = rhs.comp;
 
         data = std::move(rhs.data);
 
-        rhs.heap = nullptr;
+        rhs.keys = nullptr;
+        rhs.handles = nullptr;
+        rhs.slots = nullptr;
         rhs.size = 0;
-        rhs.elementCount = 0;      
+        rhs.elementCount = 0;
 
         return *this;
     };
 
     /**
      * Both of these must run in constant time.
+     *
+     * For a growable queue, maxSize() is the current capacity.
      */
     unsigned numElements() const {
         return elementCount;
@@ -104,22 +240,113 @@ public:
         return size;
     };
 
+    bool isGrowable() const {
+        return growable;
+    };
+
     /**
-     * Print the underlying heap level-by-level.
+     * Makes room for at least @capacity elements, so that
+     * inserting up to that many does not reallocate.
+     * Does nothing if the capacity is already large enough.
+     *
+     * For a fixed-size queue this raises its max size.
+     * Pointers returned by get() are invalidated if the
+     * storage is reallocated.
      */
-    friend std::ostream& operator<<(std::ostream& os, const PriorityQueue<ValueType>& pq)
+    void reserve(unsigned capacity) {
+        if(capacity > size) {
+            resize(capacity);
+        }
+    };
+
+    /**
+     * Enables/disables halving the capacity of a growable
+     * queue once fewer than 1/4 of its slots are in use.
+     * Off by default. Has no effect on fixed-size queues.
+     *
+     * The shrink happens in deleteMin(), deleteMinBatch() and
+     * remove(), and reallocates the storage, which invalidates
+     * pointers returned by get().
+     */
+    void setAutoShrink(bool enabled) {
+        autoShrink = enabled;
+    };
+
+    /**
+     * Replaces the contents of the priority queue with the
+     * Element<ValueType, KeyType>s in [@first, @last).
+     *
+     * The elements are copied into the heap in range order and
+     * put in heap order with Floyd's bottom-up heapify, and the
+     * position map is rebuilt in one pass. This runs in linear
+     * time.
+     *
+     * Returns true if success.
+     * Returns false if two elements share an id, or if the range
+     * is larger than the max size of a fixed-size queue.
+     * (In either of these cases, the queue is not modified.)
+     */
+    template <typename ForwardIt>
+    bool assign(ForwardIt first, ForwardIt last) {
+        unsigned count = std::distance(first, last);
+        if(count > size && !growable) {
+            return false;
+        }
+
+        PositionMap newData(nextPrime(2*count+1)); //Large enough to never rehash.
+        unsigned handle = 0;
+        for(ForwardIt it = first; it != last; ++it) {
+            if(!newData.insert(it->id, handle)) {
+                return false;
+            }
+            handle++;
+        }
+
+        elementCount = 0;
+        if(count > size) {
+            resize(count);
+        }
+
+        for(handle = 0; first != last; ++first) {
+            keys[handle+1] = first->key;
+            handles[handle+1] = handle;
+            slots[handle].id = first->id;
+            slots[handle].value = first->value;
+            slots[handle].position = handle+1;
+            handle++;
+        }
+        for(unsigned i = count+1; i <= size; i++) { //Remaining handles are free.
+            handles[i] = i-1;
+        }
+
+        elementCount = count;
+        data = std::move(newData);
+
+        if(count > 1) {
+            for(unsigned i = parent(count); i >= 1; i--) {
+                percolateDown(i);
+            }
+        }
+
+        return true;
+    };
+
+    /**
+     * Print the underlying heap level-by-level as (key,value) pairs.
+     */
+    friend std::ostream& operator<<(std::ostream& os, const PriorityQueue& pq)
     {
         unsigned counter = 0;
         unsigned current = 1;
 
         for(unsigned i = 0; i < pq.numElements(); i++) {
-            os << "(" << pq.heap[i+1].key << "," << pq.heap[i+1].value << ")";
+            os << "(" << pq.keys[i+1] << "," << pq.slots[pq.handles[i+1]].value << ")";
             counter++;
 
             if(counter == current) {
                 os << std::endl;
                 counter = 0;
-                current+=current;
+                current*=Arity;
             } else {
                 os << " ";
             }
@@ -128,60 +355,163 @@ public:
         if(counter != 0) {
             os << std::endl;
         }
-        
+
         return os;
     }
 
     /**
-     * Inserts a key-value pair mapping @key to @value into
-     * the priority queue.
+     * Inserts an element with identity @id and priority @key
+     * holding @value into the priority queue.
+     *
+     * The heap is ordered by @key, while the extended API
+     * (get, decreaseKey, increaseKey, remove) looks elements up
+     * by @id. Several elements may share the same @key.
      *
      * Returns true if success.
      * In this case, must run in logarithmic time.
      *
-     * Returns false if @key is already in the priority queue
-     * or if max size would be exceeded.
+     * Returns false if @id is already in the priority queue
+     * or if max size would be exceeded on a fixed-size queue.
      * (In either of these cases, the insertion is not performed.)
      * In this case, must run in "constant time".
+     *
+     * A growable queue doubles its capacity instead of failing
+     * (see get() about pointers).
      */
-    bool insert(unsigned key, const ValueType& value) {
-        if(elementCount >= maxSize() || data.get(key) != NULL) {
+    bool insert(unsigned id, const KeyType& key, const ValueType& value) {
+        return insertElement(id, key, value);
+    };
+
+    /**
+     * Same as above, but moves @value into the queue. @value is
+     * left as it was if the insertion is not performed.
+     */
+    bool insert(unsigned id, const KeyType& key, ValueType&& value) {
+        return insertElement(id, key, std::move(value));
+    };
+
+    /**
+     * Inserts the Element<ValueType, KeyType>s in [@first, @last).
+     *
+     * The elements are appended to the heap and the heap is
+     * repaired once for the whole batch. If the batch is large
+     * compared to the heap (at least 1/8 of the resulting size),
+     * only the subtrees above the new elements are re-heapified
+     * bottom-up, which is O(batch + log n). Otherwise each new
+     * element percolates up on its own.
+     *
+     * Elements whose id is already in the priority queue (or
+     * earlier in the batch) are skipped, as are elements that
+     * would exceed the max size of a fixed-size queue.
+     *
+     * Returns the number of elements inserted.
+     */
+    template <typename InputIt>
+    unsigned insertBatch(InputIt first, InputIt last) {
+        unsigned oldCount = elementCount;
+
+        for(; first != last; ++first) {
+            if(elementCount >= maxSize()) {
+                if(!growable) {
+                    break;
+                }
+                resize(2*size);
+            }
+            append(first->id, first->key, first->value);
+        }
+
+        repairAppended(oldCount);
+        return elementCount - oldCount;
+    };
+
+    /**
+     * Moves every element of @rhs into this priority queue,
+     * leaving @rhs empty.
+     *
+     * The elements of @rhs are appended to the heap arrays and
+     * repaired as in insertBatch(). Elements already in the queue
+     * keep their handles, so only the moved elements are added to
+     * the position map, and pointers returned by get() stay valid
+     * unless a growable queue has to grow.
+     *
+     * This function runs in time linear in the size of @rhs, plus
+     * the repair.
+     *
+     * Returns true if success.
+     * Returns false if an id is in both queues, or if this is a
+     * fixed-size queue that cannot hold the elements of both queues.
+     * (In either of these cases, nothing is moved.)
+     * Merging an empty or moved-from @rhs does nothing.
+     */
+    bool merge(PriorityQueue&& rhs) {
+        if(this == &rhs || rhs.elementCount == 0) { //Also covers a moved-from @rhs, which has no storage to reset.
+            return true;
+        }
+        if(!growable && elementCount + rhs.elementCount > size) {
             return false;
         }
+        for(unsigned i = 1; i <= rhs.elementCount; i++) {
+            if(data.get(rhs.slots[rhs.handles[i]].id) != nullptr) {
+                return false;
+            }
+        }
 
-        elementCount++;
+        if(elementCount + rhs.elementCount > size) {
+            resize(elementCount + rhs.elementCount);
+        }
 
-        heap[elementCount].key = key;
-        heap[elementCount].value = value;
-        
-        unsigned newIndex = percolateUp(elementCount); //Maintain min heap properties by moving inserted key up.
-        data.insert(key, newIndex);
+        unsigned oldCount = elementCount;
+        for(unsigned i = 1; i <= rhs.elementCount; i++) {
+            Slot& slot = rhs.slots[rhs.handles[i]];
+            append(slot.id, rhs.keys[i], std::move(slot.value));
+        }
+        repairAppended(oldCount);
+
+        rhs.elementCount = 0;
+        for(unsigned i = 1; i <= rhs.size; i++) {
+            rhs.handles[i] = i-1;
+        }
+        rhs.data = PositionMap(rhs.nextPrime(rhs.size));
+        rhs.checkShrink();
 
         return true;
     };
 
     /**
-     * Returns key of the smallest element in the priority queue
-     * or null pointer if empty.
-     *
-     * This function runs in constant time.
-     *
-     * The pointer may be invalidated if the priority queue is modified.
+     * Inserts a key-value pair mapping @key to @value, using
+     * @key both as the priority and as the identity of the element.
      */
-    const unsigned* getMinKey() const {
-        return &heap[1].key;
+    bool insert(unsigned key, const ValueType& value) {
+        return insert(key, key, value);
     };
 
     /**
-     * Returns value of the smallest element in the priority queue
-     * or null pointer if empty.
+     * Returns key, id or value of the smallest element in the
+     * priority queue or null pointer if empty.
      *
-     * This function runs in constant time.
+     * These functions run in constant time.
      *
      * The pointer may be invalidated if the priority queue is modified.
      */
+    const KeyType* getMinKey() const {
+        if(elementCount == 0) {
+            return nullptr;
+        }
+        return &keys[1];
+    };
+
+    const unsigned* getMinId() const {
+        if(elementCount == 0) {
+            return nullptr;
+        }
+        return &slots[handles[1]].id;
+    };
+
     const ValueType* getMinValue() const {
-        return &heap[1].value;
+        if(elementCount == 0) {
+            return nullptr;
+        }
+        return &slots[handles[1]].value;
     };
 
     /**
@@ -191,152 +521,319 @@ public:
      *
      * Returns true if success.
      * Returns false if priority queue is empty, i.e. nothing to delete.
+     *
+     * May auto-shrink a growable queue (see setAutoShrink()).
      */
     bool deleteMin() {
         if(elementCount == 0) {
             return false;
         }
-        
-        data.remove(*getMinKey());
-        heap[1] = heap[elementCount];
-        elementCount--;
 
-        unsigned newIndex = percolateDown(1); //Maintain min heap properties by moving new root down.
-        data.update(heap[newIndex].key, newIndex);
+        data.remove(slots[popRoot()].id);
+        checkShrink();
+        return true;
+    };
+
+    /**
+     * Replaces the smallest element with a new element with
+     * identity @id and priority @key holding @value.
+     *
+     * Same result as deleteMin() followed by insert(@id, @key, @value),
+     * but the new element takes over the root (and its slot) and
+     * percolates down once, instead of a percolate down for the
+     * delete plus a percolate up for the insert.
+     *
+     * This function runs in logarithmic time.
+     *
+     * Returns true if success.
+     * Returns false if the priority queue is empty, or if @id is
+     * already in the priority queue and is not the smallest element.
+     */
+    bool replaceMin(unsigned id, const KeyType& key, const ValueType& value) {
+        if(elementCount == 0) {
+            return false;
+        }
+
+        unsigned handle = handles[1];
+        if(slots[handle].id != id) {
+            if(data.get(id) != nullptr) {
+                return false;
+            }
+            data.remove(slots[handle].id);
+            data.insert(id, handle);
+        }
+
+        slots[handle].id = id;
+        slots[handle].value = value;
+        keys[1] = key;
+        percolateDown(1);
+
+        return true;
+    };
+
+    /**
+     * Inserts a new element with identity @id and priority @key
+     * holding @value, then removes the smallest element and
+     * stores it in @out.
+     *
+     * If the new element would be the smallest, it is handed back
+     * in @out without touching the heap. Otherwise the old root is
+     * moved to @out and replaced as in replaceMin().
+     *
+     * This function runs in logarithmic time.
+     *
+     * Returns true if success.
+     * Returns false if @id is already in the priority queue
+     * (in which case nothing is inserted or removed).
+     */
+    bool pushPop(unsigned id, const KeyType& key, const ValueType& value, Element<ValueType, KeyType>& out) {
+        if(data.get(id) != nullptr) {
+            return false;
+        }
+
+        if(elementCount == 0 || !before(keys[1], key)) {
+            out.id = id;
+            out.key = key;
+            out.value = value;
+            return true;
+        }
+
+        unsigned handle = handles[1];
+        out.id = slots[handle].id;
+        out.key = keys[1];
+        out.value = std::move(slots[handle].value);
+
+        data.remove(out.id);
+        data.insert(id, handle);
+
+        slots[handle].id = id;
+        slots[handle].value = value;
+        keys[1] = key;
+        percolateDown(1);
+
         return true;
     };
 
     /**
-     * Returns address of the value that @key is mapped to in the priority queue.
+     * Removes the (at most) @k smallest elements, writing them in
+     * ascending key order to @out as Element<ValueType, KeyType>s (values
+     * are moved out of the queue).
+     *
+     * Equivalent to calling getMinId/getMinKey/getMinValue and
+     * deleteMin @k times, but the position map is updated in a
+     * single pass at the end.
+     *
+     * This function runs in O(k log n) time.
+     *
+     * Returns the number of elements removed.
+     *
+     * May auto-shrink a growable queue (see setAutoShrink()).
+     */
+    template <typename OutputIt>
+    unsigned deleteMinBatch(unsigned k, OutputIt out) {
+        if(k > elementCount) {
+            k = elementCount;
+        }
+
+        for(unsigned i = 0; i < k; i++) {
+            Slot& slot = slots[handles[1]];
+            *out = Element<ValueType, KeyType>{slot.id, keys[1], std::move(slot.value)};
+            ++out;
+            popRoot();
+        }
+
+        //The freed handles now sit right past the end of the heap.
+        for(unsigned i = elementCount+1; i <= elementCount+k; i++) {
+            data.remove(slots[handles[i]].id);
+        }
+
+        checkShrink();
+        return k;
+    };
+
+    /**
+     * Returns address of the value of the element with identity @id.
      *
      * These functions run in "constant time".
      *
-     * Returns null pointer if @key is not in the table.
+     * Returns null pointer if @id is not in the priority queue.
+     *
+     * The pointer stays valid when other operations reorder the
+     * heap. It is invalidated when the element is removed or the
+     * storage is resized (reserve(), or growing or auto-shrinking
+     * a growable queue).
      */
-    ValueType* get(unsigned key) {
-        if(data.get(key) == NULL) {
+    ValueType* get(unsigned id) {
+        const unsigned* handle = data.get(id);
+        if(handle == nullptr) {
             return nullptr;
         }
 
-        return &heap[*data.get(key)].value;
+        return &slots[*handle].value;
     };
 
-    const ValueType* get(unsigned key) const {
-        if(data.get(key) == NULL) {
+    const ValueType* get(unsigned id) const {
+        const unsigned* handle = data.get(id);
+        if(handle == nullptr) {
             return nullptr;
         }
-        
-        return &heap[*data.get(key)].value;
+
+        return &slots[*handle].value;
     };
 
     /**
-     * Subtracts/adds @change from/to the key of
-     * the element that has key @key.
+     * Returns address of the priority of the element with identity @id.
+     *
+     * This function runs in "constant time".
+     *
+     * Returns null pointer if @id is not in the priority queue.
+     *
+     * The pointer may be invalidated if the priority queue is modified.
+     */
+    const KeyType* getKey(unsigned id) const {
+        const unsigned* handle = data.get(id);
+        if(handle == nullptr) {
+            return nullptr;
+        }
+
+        return &keys[slots[*handle].position];
+    };
+
+    /**
+     * Subtracts/adds @change from/to the priority of
+     * the element that has identity @id.
      *
      * These functions run in "constant time" + logarithmic time.
      * This means you must use the required hash table to find the
-     * location of @key in the underlying binary heap array.
+     * location of @id in the underlying heap array.
      *
      * Returns true if success.
      * Returns false if any of the following:
      * - @change is 0.
-     * - @key not found.
-     * - If the change would lead to a duplicate key.
+     * - @id not found.
      *
      * The function does not do anything about  overflow/underflow.
-     * For example, an operation like decreaseKey(2, 10)
-     * has an undefined effect.
+     * For example, an operation like decreaseKey(2, 10) on an
+     * element with priority 2 has an undefined effect.
+     *
+     * With the default order a smaller key comes out earlier; with
+     * another Compare the element moves whichever way the new key
+     * requires. KeyType needs - and + for these (see updateKey()).
      */
-    bool decreaseKey(unsigned key, unsigned change) {
-        if(change == 0 || data.get(key) == nullptr || data.get(key - change) != nullptr) {
+    bool decreaseKey(unsigned id, const KeyType& change) {
+        const unsigned* handle = data.get(id);
+        if(change == KeyType() || handle == nullptr) {
             return false;
         }
-        unsigned index = *data.get(key);
-        data.remove(key);
 
-        heap[index].key -= change;
-        unsigned newIndex = percolateUp(index);
-
-        data.insert(heap[newIndex].key, newIndex);
+        unsigned index = slots[*handle].position;
+        rekey(index, keys[index] - change);
 
         return true;
     };
 
-    bool increaseKey(unsigned key, unsigned change) {
-        if(change == 0 || data.get(key) == nullptr || data.get(key + change) != nullptr) {
+    bool increaseKey(unsigned id, const KeyType& change) {
+        const unsigned* handle = data.get(id);
+        if(change == KeyType() || handle == nullptr) {
             return false;
         }
-        unsigned index = *data.get(key);
-        data.remove(key);
 
-        heap[index].key += change;
-        unsigned newIndex = percolateDown(index);
+        unsigned index = slots[*handle].position;
+        rekey(index, keys[index] + change);
 
-        data.insert(heap[newIndex].key, newIndex);        
+        return true;
+    };
 
+    /**
+     * Sets the priority of the element that has identity @id
+     * to @key, for key types without arithmetic (e.g. tuples).
+     *
+     * This function runs in "constant time" + logarithmic time.
+     *
+     * Returns true if success.
+     * Returns false if @id not found.
+     */
+    bool updateKey(unsigned id, const KeyType& key) {
+        const unsigned* handle = data.get(id);
+        if(handle == nullptr) {
+            return false;
+        }
+
+        rekey(slots[*handle].position, key);
         return true;
     };
 
     /**
-     * Removes element that has key @key.
+     * Removes element that has identity @id.
      *
      * These functions run in "constant time" + logarithmic time.
      * This means you must use the required hash table to find the
-     * location of @key in the underlying binary heap array.
+     * location of @id in the underlying heap array.
      *
      * Returns true if success.
-     * Returns false if @key not found.
+     * Returns false if @id not found.
+     *
+     * May auto-shrink a growable queue (see setAutoShrink()).
      */
-    bool remove(unsigned key) {
-        if(data.get(key) == NULL) {
+    bool remove(unsigned id) {
+        const unsigned* found = data.get(id);
+        if(found == nullptr) {
             return false;
         }
 
-        bool up = false;
-        unsigned newIndex;
-
-        unsigned index = *data.get(key);
-        data.remove(key);
-
-        heap[index] = heap[numElements()];
+        unsigned handle = *found;
+        unsigned index = slots[handle].position;
+        data.remove(id);
 
-        newIndex = percolateDown(index); //Attempts percolate down.
-
-        if(newIndex == index) { //If no percolation down occurs, attempts percolate up.
-            newIndex = percolateUp(index);
-            up = true;
-        }
+        keys[index] = std::move(keys[elementCount]);
+        handles[index] = handles[elementCount];
+        handles[elementCount] = handle; //Return the handle to the free list.
+        elementCount--;
 
-        if(up) {
-            index = newIndex;
+        if(index > elementCount) { //Removed the last element, nothing to repair.
+            checkShrink();
+            return true;
         }
 
-        data.update(heap[index].key, index);
-
-        elementCount--;
-
-        while(index <= elementCount) { //Updates indexes in hash table.
-            if(*data.get(heap[index].key) != index) {
-                data.update(heap[index].key, index);
-            }
-            index++;
+        //Percolating updates the position of every entry it moves, so nothing else needs fixing.
+        if(percolateDown(index) == index) { //If no percolation down occurs, attempts percolate up.
+            percolateUp(index);
         }
 
-        return true; 
+        checkShrink();
+        return true;
     };
 
 private:
-    Pair<ValueType>* heap;
-    HashTable<unsigned> data;
+    struct Slot {
+        unsigned id;
+        ValueType value;
+        unsigned position;
+    };
+
+    KeyType* keys;
+    unsigned* handles;
+    Slot* slots;
+    PositionMap data;
     unsigned size;
     unsigned elementCount;
+    bool growable;
+    bool autoShrink;
+    Compare comp; //Copied rather than moved, so a moved-from queue can still compare.
+
+    static constexpr unsigned initialCapacity = 8;
+    static constexpr std::size_t cacheLine = 64;
+    static constexpr std::size_t keyAlignment = alignof(KeyType) > cacheLine ? alignof(KeyType) : cacheLine;
+    static constexpr std::size_t keysPerLine = cacheLine % sizeof(KeyType) == 0 ? cacheLine/sizeof(KeyType) : 0;
+    static constexpr std::size_t keyPadding = keysPerLine == 0 ? 0 : (keysPerLine - 2%keysPerLine) % keysPerLine; //Puts keys[2], the first child of the root, on a line boundary.
+    static constexpr bool defaultOrder = std::is_same<KeyType, unsigned>::value && std::is_same<Compare, std::less<unsigned>>::value; //Unsigned min-heap: SIMD applies.
 
     bool isPrime(unsigned value) {
         if(value == 1) {
             return false;
         }
 
-        for(unsigned i = 2; i < value; i++) {
+        for(unsigned i = 2; i*i <= value; i++) {
             if(value % i == 0) {
                 return false;
             }
@@ -347,66 +844,296 @@ private:
 
     int nextPrime(unsigned value) {
         int primeNum = value;
-        
+
         while(!isPrime(primeNum)) {
             primeNum++;
         }
         return primeNum;
     }
 
-    unsigned leftChild(unsigned index) {
-        return 2*index;
+    /**
+     * Returns an array of @count default-constructed keys, placed
+     * keyPadding keys past the start of a cache-line-aligned
+     * block (see the class comment).
+     */
+    static KeyType* allocateKeys(unsigned count) {
+        KeyType* block = static_cast<KeyType*>(::operator new((keyPadding+count)*sizeof(KeyType), std::align_val_t(keyAlignment)));
+        try {
+            std::uninitialized_default_construct_n(block+keyPadding, count);
+        } catch(...) {
+            ::operator delete(block, std::align_val_t(keyAlignment));
+            throw;
+        }
+        return block+keyPadding;
     }
-    unsigned rightChild(unsigned index) {
-        return (2*index)+1;
+
+    /**
+     * Destroys and frees an array of @count keys made by
+     * allocateKeys(). Does nothing for nullptr.
+     */
+    static void freeKeys(KeyType* keys, unsigned count) {
+        if(keys == nullptr) {
+            return;
+        }
+        std::destroy_n(keys, count);
+        ::operator delete(keys-keyPadding, std::align_val_t(keyAlignment));
     }
-    unsigned parent(unsigned index) {
-        return index/2;
+
+    void copyArrays(const PriorityQueue& rhs) {
+        for(unsigned i = 0; i < rhs.maxSize()+1; i++) {
+            keys[i] = rhs.keys[i];
+            handles[i] = rhs.handles[i];
+        }
+        for(unsigned i = 0; i < rhs.maxSize(); i++) {
+            slots[i] = rhs.slots[i];
+        }
     }
 
-    unsigned percolateUp(unsigned index) {
-        Pair<ValueType> temp;
-        while(index > 1 && heap[parent(index)].key > heap[index].key) {
-            temp = heap[parent(index)];
-            heap[parent(index)] = heap[index];
-            heap[index] = temp;
+    /**
+     * Reallocates the heap and slot arrays to hold @newSize
+     * elements (@newSize >= elementCount). Live elements are
+     * compacted so the element at heap index i gets handle i-1,
+     * and the position map is updated to match.
+     */
+    void resize(unsigned newSize) {
+        KeyType* newKeys = allocateKeys(newSize+1);
+        unsigned* newHandles = new unsigned[newSize+1];
+        Slot* newSlots = new Slot[newSize];
+
+        for(unsigned i = 1; i <= elementCount; i++) {
+            Slot& slot = slots[handles[i]];
+            newKeys[i] = keys[i];
+            newHandles[i] = i-1;
+            newSlots[i-1].id = slot.id;
+            newSlots[i-1].value = std::move(slot.value);
+            newSlots[i-1].position = i;
+            data.update(slot.id, i-1);
+        }
+        for(unsigned i = elementCount+1; i <= newSize; i++) {
+            newHandles[i] = i-1;
+        }
 
-            data.update(heap[index].key, index);
+        freeKeys(keys, size+1);
+        delete[] handles;
+        delete[] slots;
+        keys = newKeys;
+        handles = newHandles;
+        slots = newSlots;
+        size = newSize;
+    }
 
-            index = parent(index);
+    /**
+     * Adds an element right after the last heap entry, without
+     * restoring the heap order (see repairAppended()). There must
+     * be room for it.
+     *
+     * Returns false (and does nothing) if @id is already present.
+     */
+    template <typename V>
+    bool append(unsigned id, const KeyType& key, V&& value) {
+        unsigned handle = handles[elementCount+1];
+        if(!data.insert(id, handle)) {
+            return false;
         }
-        return index;
+
+        elementCount++;
+        slots[handle].id = id;
+        slots[handle].value = std::forward<V>(value);
+        slots[handle].position = elementCount;
+        keys[elementCount] = key;
+        return true;
     }
 
-    unsigned percolateDown(unsigned index) {
-        Pair<ValueType> temp;
-        unsigned smallest = index;
+    /**
+     * Does the work of insert(), copying or moving @value in.
+     */
+    template <typename V>
+    bool insertElement(unsigned id, const KeyType& key, V&& value) {
+        if(data.get(id) != nullptr) {
+            return false;
+        }
+        if(elementCount >= maxSize()) {
+            if(!growable) {
+                return false;
+            }
+            resize(2*size);
+        }
+
+        elementCount++;
 
-        bool baseCase = false;
+        unsigned handle = handles[elementCount]; //Free handles are kept past the end of the heap.
+        slots[handle].id = id;
+        slots[handle].value = std::forward<V>(value);
+        keys[elementCount] = key;
 
-        if(elementCount <= 2) { //Base case for when only two elements in heap.
-            baseCase = true;
+        percolateUp(elementCount); //Maintain min heap properties by moving inserted key up.
+        data.insert(id, handle);
+
+        return true;
+    }
+
+    /**
+     * Restores the heap order after entries were appended past
+     * the first @oldCount ones.
+     *
+     * If many entries were appended (at least 1/8 of the heap),
+     * the subtrees above them are re-heapified level by level,
+     * from the parents of the new entries up to the root.
+     * Otherwise each new entry percolates up on its own.
+     */
+    void repairAppended(unsigned oldCount) {
+        unsigned added = elementCount - oldCount;
+        if(added == 0) {
+            return;
         }
 
-        while((rightChild(index) < elementCount || leftChild(index) < elementCount || baseCase) && (heap[index].key > heap[leftChild(index)].key || heap[index].key > heap[rightChild(index)].key)) {
-            
-            if(heap[leftChild(index)].key > heap[rightChild(index)].key) {
-                smallest = rightChild(index);
-            } else {
-                smallest = leftChild(index);
+        if(oldCount == 0 || 8*added >= elementCount) {
+            unsigned low = (oldCount == 0) ? 1 : parent(oldCount+1);
+            unsigned high = parent(elementCount);
+            if(elementCount == 1) {
+                high = 0;
+            }
+            while(high >= 1) {
+                for(unsigned i = high; i >= low; i--) {
+                    percolateDown(i);
+                }
+                if(low == 1) {
+                    break;
+                }
+                low = parent(low);
+                high = parent(high);
+            }
+        } else {
+            for(unsigned i = oldCount+1; i <= elementCount; i++) {
+                percolateUp(i);
             }
+        }
+    }
+
+    /**
+     * Removes the root from the heap and returns its handle,
+     * which goes back to the free list. The position map is
+     * left to the caller.
+     */
+    unsigned popRoot() {
+        unsigned handle = handles[1];
+
+        keys[1] = std::move(keys[elementCount]);
+        handles[1] = handles[elementCount];
+        handles[elementCount] = handle; //Return the handle to the free list.
+        elementCount--;
+
+        if(elementCount > 0) {
+            percolateDown(1); //Maintain min heap properties by moving new root down.
+        }
+        return handle;
+    }
 
-            if(smallest != index) {
-                temp = heap[index];
-                heap[index] = heap[smallest];
-                heap[smallest] = temp;
+    void checkShrink() {
+        if(growable && autoShrink && size > initialCapacity && elementCount < size/4) {
+            resize(size/2);
+        }
+    }
+
+    unsigned firstChild(unsigned index) {
+        return Arity*(index-1)+2;
+    }
+    unsigned parent(unsigned index) {
+        return (index-2)/Arity+1;
+    }
 
-                data.update(heap[index].key, index);
+    /**
+     * Returns true if @a comes out before @b.
+     */
+    bool before(const KeyType& a, const KeyType& b) const {
+        return comp(a, b);
+    }
+
+    /**
+     * Gives the entry at @index the priority @key and moves it
+     * whichever way it needs to go.
+     */
+    void rekey(unsigned index, const KeyType& key) {
+        bool earlier = before(key, keys[index]);
+        keys[index] = key;
+        if(earlier) {
+            percolateUp(index);
+        } else {
+            percolateDown(index);
+        }
+    }
+
+    /**
+     * Returns the index of the child of @index with the smallest key.
+     * @index must have at least one child.
+     */
+    unsigned minChild(unsigned index) {
+        unsigned first = firstChild(index);
+        unsigned last = first+Arity-1;
+        if(last > elementCount) {
+            last = elementCount;
+        }
 
-                index = smallest;
+        if constexpr(defaultOrder) {
+            if constexpr(Arity % 4 == 0) {
+                if(last-first+1 == Arity) { //Full block of children, can be vectorized.
+                    return first + minIndex(&keys[first], Arity);
+                }
             }
-            baseCase = false;
+            return first + minIndexScalar(&keys[first], last-first+1);
+        } else {
+            unsigned smallest = first;
+            for(unsigned i = first+1; i <= last; i++) {
+                if(before(keys[i], keys[smallest])) {
+                    smallest = i;
+                }
+            }
+            return smallest;
+        }
+    }
+
+    /**
+     * Both percolate functions carry the entry at @index in a
+     * "hole": parents/children are shifted into the hole one
+     * level at a time and the moving entry is written once, at
+     * its final index, which is returned. Every entry that ends
+     * up at a new index, including the moving one, has its
+     * slot's position updated.
+     */
+    unsigned percolateUp(unsigned index) {
+        KeyType key = std::move(keys[index]);
+        unsigned handle = handles[index];
+
+        while(index > 1 && before(key, keys[parent(index)])) {
+            keys[index] = std::move(keys[parent(index)]);
+            handles[index] = handles[parent(index)];
+            slots[handles[index]].position = index;
+
+            index = parent(index);
         }
+
+        keys[index] = std::move(key);
+        handles[index] = handle;
+        slots[handle].position = index;
+        return index;
+    }
+
+    unsigned percolateDown(unsigned index) {
+        KeyType key = std::move(keys[index]);
+        unsigned handle = handles[index];
+        unsigned smallest;
+
+        while(firstChild(index) <= elementCount && before(keys[smallest = minChild(index)], key)) {
+            keys[index] = std::move(keys[smallest]);
+            handles[index] = handles[smallest];
+            slots[handles[index]].position = index;
+
+            index = smallest;
+        }
+
+        keys[index] = std::move(key);
+        handles[index] = handle;
+        slots[handle].position = index;
         return index;
     }
 };
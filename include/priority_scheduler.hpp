@@ -0,0 +1,231 @@
+#ifndef PRIORITY_SCHEDULER_HPP
+#define PRIORITY_SCHEDULER_HPP
+
+#include "priority_queue.hpp"
+#include "thread_random.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+/**
+ * A work-stealing executor for tasks with an unsigned priority,
+ * where smaller keys run first.
+ *
+ * Each worker thread owns a PriorityQueue of tasks behind its own
+ * mutex; there is no global queue. A task submitted from a worker
+ * goes to that worker's queue, and a worker always runs the best
+ * task of its own queue first. When its queue is empty it steals
+ * from the other workers, starting at a random one: it takes the
+ * best half of the victim's tasks (with deleteMinBatch) in one go,
+ * so that it does not have to come back for every task. Tasks
+ * submitted from outside the pool are spread over the workers
+ * round-robin.
+ *
+ * Priorities are only followed within a queue: a worker runs the
+ * best task it has, which may be worse than the best task of
+ * another worker.
+ *
+ * Idle workers sleep on a condition variable that submit() only
+ * touches when someone is asleep.
+ */
+class PriorityScheduler
+{
+public:
+    typedef std::function<void()> Task;
+
+    /**
+     * Starts @workers worker threads.
+     */
+    explicit PriorityScheduler(unsigned workers) : queues(workers), pending(0), outstanding(0), sleepers(0), nextQueue(0), stopping(false) {
+        if(workers == 0) {
+            throw std::runtime_error("workers cannot be <= 0!");
+        }
+        for(unsigned i = 0; i < workers; i++) {
+            queues[i].reset(new LocalQueue());
+        }
+        for(unsigned i = 0; i < workers; i++) {
+            threads.emplace_back(&PriorityScheduler::run, this, i);
+        }
+    };
+
+    PriorityScheduler(const PriorityScheduler& rhs) = delete;
+    PriorityScheduler& operator=(const PriorityScheduler& rhs) = delete;
+
+    /**
+     * Runs every task that was submitted, then stops the workers.
+     */
+    ~PriorityScheduler() {
+        waitIdle();
+        {
+            std::lock_guard<std::mutex> lock(idleMutex);
+            stopping = true;
+        }
+        idleCv.notify_all();
+        for(unsigned i = 0; i < threads.size(); i++) {
+            threads[i].join();
+        }
+    };
+
+    unsigned numWorkers() const {
+        return queues.size();
+    };
+
+    /**
+     * Schedules @task with priority @key. Tasks must not throw.
+     *
+     * Throws std::runtime_error if the task cannot be queued (in
+     * which case, it is not scheduled).
+     */
+    void submit(unsigned key, Task task) {
+        unsigned target = (currentScheduler == this) ? currentWorker : nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+        {
+            LocalQueue& queue = *queues[target];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if(!queue.tasks.insert(freeId(queue), key, std::move(task))) {
+                throw std::runtime_error("Task could not be queued!");
+            }
+            //Counted before the lock is released, so no worker can take the task first.
+            outstanding.fetch_add(1);
+            pending.fetch_add(1);
+        }
+
+        if(sleepers.load() > 0) {
+            std::lock_guard<std::mutex> lock(idleMutex);
+            idleCv.notify_one();
+        }
+    };
+
+    /**
+     * Blocks until every submitted task has finished running.
+     * Must not be called from a task.
+     */
+    void waitIdle() {
+        std::unique_lock<std::mutex> lock(idleMutex);
+        doneCv.wait(lock, [this]() { return outstanding.load() == 0; });
+    };
+
+private:
+    struct alignas(64) LocalQueue {
+        std::mutex mutex;
+        PriorityQueue<Task> tasks;
+        unsigned nextId = 0; //Task ids only need to be unique within a queue.
+    };
+
+    std::vector<std::unique_ptr<LocalQueue>> queues;
+    std::vector<std::thread> threads;
+    std::atomic<unsigned> pending; //Tasks in queues, not yet started.
+    std::atomic<unsigned> outstanding; //Tasks submitted and not yet finished.
+    std::atomic<unsigned> sleepers;
+    std::atomic<unsigned> nextQueue;
+    std::mutex idleMutex;
+    std::condition_variable idleCv;
+    std::condition_variable doneCv;
+    bool stopping;
+
+    static thread_local PriorityScheduler* currentScheduler;
+    static thread_local unsigned currentWorker;
+
+    /**
+     * Returns an id that no task in @queue has, for a new task.
+     * Ids are handed out in order and only skip ids that are still
+     * taken after nextId wraps around. @queue must be locked.
+     */
+    static unsigned freeId(LocalQueue& queue) {
+        while(queue.tasks.get(queue.nextId) != nullptr) {
+            queue.nextId++;
+        }
+        return queue.nextId++;
+    }
+
+    /**
+     * Takes the best task of worker @self's queue into @task.
+     */
+    bool popLocal(unsigned self, Task& task) {
+        LocalQueue& queue = *queues[self];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        Element<Task> best;
+        if(queue.tasks.deleteMinBatch(1, &best) == 0) {
+            return false;
+        }
+        task = std::move(best.value);
+        return true;
+    }
+
+    /**
+     * Moves the best half of another worker's tasks into worker
+     * @self's queue and takes the best of them into @task.
+     */
+    bool steal(unsigned self, Task& task) {
+        std::vector<Element<Task>> stolen;
+        unsigned start = randomWorker();
+        for(unsigned i = 0; i < queues.size() && stolen.empty(); i++) {
+            unsigned victim = (start + i) % queues.size();
+            if(victim == self) {
+                continue;
+            }
+            LocalQueue& queue = *queues[victim];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.deleteMinBatch((queue.tasks.numElements()+1) / 2, std::back_inserter(stolen));
+        }
+        if(stolen.empty()) {
+            return false;
+        }
+
+        task = std::move(stolen[0].value);
+        if(stolen.size() > 1) {
+            LocalQueue& queue = *queues[self];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            for(unsigned i = 1; i < stolen.size(); i++) { //Ids of the victim may clash with ours.
+                stolen[i].id = freeId(queue);
+            }
+            queue.tasks.insertBatch(stolen.begin()+1, stolen.end());
+        }
+        return true;
+    }
+
+    /**
+     * Returns a random worker index (see thread_random.hpp).
+     */
+    unsigned randomWorker() const {
+        return threadRandom() % queues.size();
+    }
+
+    void run(unsigned self) {
+        currentScheduler = this;
+        currentWorker = self;
+
+        Task task;
+        while(true) {
+            if(popLocal(self, task) || steal(self, task)) {
+                pending.fetch_sub(1);
+                task();
+                task = nullptr;
+                if(outstanding.fetch_sub(1) == 1) {
+                    std::lock_guard<std::mutex> lock(idleMutex);
+                    doneCv.notify_all();
+                }
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(idleMutex);
+            sleepers.fetch_add(1);
+            idleCv.wait(lock, [this]() { return pending.load() > 0 || stopping; });
+            sleepers.fetch_sub(1);
+            if(stopping && pending.load() == 0) {
+                return;
+            }
+        }
+    }
+};
+
+inline thread_local PriorityScheduler* PriorityScheduler::currentScheduler = nullptr;
+inline thread_local unsigned PriorityScheduler::currentWorker = 0;
+
+#endif  // PRIORITY_SCHEDULER_HPP
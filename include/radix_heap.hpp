@@ -0,0 +1,370 @@
+#ifndef RADIX_HEAP_HPP
+#define RADIX_HEAP_HPP
+
+#include "hash_table.hpp"
+#include "direct_index_map.hpp"
+#include "node_pool.hpp"
+
+#include <utility>
+#include <vector>
+
+/**
+ * Implementation of a radix heap with the same extended API as
+ * PriorityQueue, for monotone priorities: a key may never be
+ * smaller than the last minimum taken out of the heap (event
+ * simulation, Dijkstra with non-negative weights, ...).
+ *
+ * Elements are kept in buckets relative to "last", the last
+ * minimum. Bucket 0 holds the elements whose key equals last,
+ * and bucket b > 0 holds the elements whose key differs from
+ * last first in bit b-1 (counting from the least significant
+ * bit). Placing an element is a single xor and count-leading-zeros,
+ * with no key comparisons. When the minimum is needed and bucket 0
+ * is empty, the first non-empty bucket is found from a bitmask,
+ * its smallest key becomes the new last, and its elements move to
+ * lower buckets.
+ * An element can only move down, so each one moves at most once
+ * per bit of the key: operations take O(log C) amortized time,
+ * where C is the largest key.
+ *
+ * A bucket is a vector of node indices, and each node remembers
+ * its bucket and its place in it, so decreaseKey, increaseKey and
+ * remove go from the id to the bucket entry without searching.
+ */
+template <typename ValueType, typename PositionMap = HashTable<unsigned>>
+class RadixHeap
+{
+public:
+    /**
+     * Creates an empty radix heap.
+     */
+    RadixHeap() : data(initialMapSize), last(0), nonEmpty(0), elementCount(0) {};
+
+    /**
+     * Makes room for @capacity nodes, so that inserting up to
+     * that many elements does not reallocate the node pool.
+     */
+    void reserve(unsigned capacity) {
+        nodes.reserve(capacity);
+    };
+
+    /**
+     * Must run in constant time.
+     */
+    unsigned numElements() const {
+        return elementCount;
+    };
+
+    /**
+     * Returns the smallest key that may still be inserted: the
+     * last minimum looked up with getMin* or removed with
+     * deleteMin (0 at first).
+     */
+    unsigned lastKey() const {
+        return last;
+    };
+
+    /**
+     * Inserts an element with identity @id and priority @key
+     * holding @value into the heap.
+     *
+     * This function runs in constant time (amortized over the
+     * growth of the node pool).
+     *
+     * Returns true if success.
+     * Returns false if any of the following
+     * (in which case, the insertion is not performed):
+     * - @id is already in the heap.
+     * - @key is smaller than lastKey().
+     */
+    bool insert(unsigned id, unsigned key, const ValueType& value) {
+        if(key < last) {
+            return false;
+        }
+
+        unsigned node = nodes.allocate();
+        if(!data.insert(id, node)) {
+            nodes.release(node);
+            return false;
+        }
+
+        nodes[node].id = id;
+        nodes[node].key = key;
+        nodes[node].value = value;
+        attach(node, bucketOf(key));
+        elementCount++;
+        return true;
+    };
+
+    /**
+     * Inserts a key-value pair mapping @key to @value, using
+     * @key both as the priority and as the identity of the element.
+     */
+    bool insert(unsigned key, const ValueType& value) {
+        return insert(key, key, value);
+    };
+
+    /**
+     * Returns key, id or value of the smallest element in the
+     * heap or null pointer if empty.
+     *
+     * These functions run in constant time if the minimum is
+     * already known, and O(log C) amortized time otherwise. Looking
+     * up the minimum makes it the new lastKey().
+     *
+     * The pointer may be invalidated if the heap is modified.
+     */
+    const unsigned* getMinKey() const {
+        if(elementCount == 0) {
+            return nullptr;
+        }
+        return &nodes[minNode()].key;
+    };
+
+    const unsigned* getMinId() const {
+        if(elementCount == 0) {
+            return nullptr;
+        }
+        return &nodes[minNode()].id;
+    };
+
+    const ValueType* getMinValue() const {
+        if(elementCount == 0) {
+            return nullptr;
+        }
+        return &nodes[minNode()].value;
+    };
+
+    /**
+     * Removes the smallest element of the heap.
+     *
+     * This function runs in O(log C) amortized time.
+     *
+     * Returns true if success.
+     * Returns false if heap is empty, i.e. nothing to delete.
+     */
+    bool deleteMin() {
+        if(elementCount == 0) {
+            return false;
+        }
+
+        removeNode(minNode());
+        return true;
+    };
+
+    /**
+     * Returns address of the value of the element with identity @id.
+     *
+     * These functions run in "constant time".
+     *
+     * Returns null pointer if @id is not in the heap.
+     *
+     * The pointer may be invalidated if an insert grows the node pool.
+     */
+    ValueType* get(unsigned id) {
+        const unsigned* node = data.get(id);
+        if(node == nullptr) {
+            return nullptr;
+        }
+        return &nodes[*node].value;
+    };
+
+    const ValueType* get(unsigned id) const {
+        const unsigned* node = data.get(id);
+        if(node == nullptr) {
+            return nullptr;
+        }
+        return &nodes[*node].value;
+    };
+
+    /**
+     * Returns address of the priority of the element with identity @id,
+     * or null pointer if @id is not in the heap.
+     */
+    const unsigned* getKey(unsigned id) const {
+        const unsigned* node = data.get(id);
+        if(node == nullptr) {
+            return nullptr;
+        }
+        return &nodes[*node].key;
+    };
+
+    /**
+     * Subtracts/adds @change from/to the priority of
+     * the element that has identity @id.
+     *
+     * Both run in constant time: the element moves to the
+     * bucket of its new key.
+     *
+     * Returns true if success.
+     * Returns false if any of the following:
+     * - @change is 0.
+     * - @id not found.
+     * - decreaseKey only: the new key would be smaller than lastKey().
+     *
+     * increaseKey does not do anything about overflow.
+     */
+    bool decreaseKey(unsigned id, unsigned change) {
+        const unsigned* found = data.get(id);
+        if(change == 0 || found == nullptr) {
+            return false;
+        }
+
+        unsigned node = *found;
+        if(change > nodes[node].key - last) { //Would go below last.
+            return false;
+        }
+
+        detach(node);
+        nodes[node].key -= change;
+        attach(node, bucketOf(nodes[node].key));
+        return true;
+    };
+
+    bool increaseKey(unsigned id, unsigned change) {
+        const unsigned* found = data.get(id);
+        if(change == 0 || found == nullptr) {
+            return false;
+        }
+
+        unsigned node = *found;
+        detach(node);
+        nodes[node].key += change;
+        attach(node, bucketOf(nodes[node].key));
+        return true;
+    };
+
+    /**
+     * Removes element that has identity @id.
+     *
+     * This function runs in constant time.
+     *
+     * Returns true if success.
+     * Returns false if @id not found.
+     */
+    bool remove(unsigned id) {
+        const unsigned* found = data.get(id);
+        if(found == nullptr) {
+            return false;
+        }
+
+        removeNode(*found);
+        return true;
+    };
+
+private:
+    struct Node {
+        unsigned id;
+        unsigned key;
+        ValueType value;
+        unsigned bucket;
+        unsigned index; //Position in the bucket, or next free node.
+    };
+
+    static constexpr unsigned none = ~0u;
+    static constexpr unsigned initialMapSize = 11;
+    static constexpr unsigned keyBits = 8*sizeof(unsigned);
+    static constexpr unsigned bucketCount = keyBits+1;
+
+    //Finding the minimum redistributes a bucket, which the const
+    //getMin* functions do too.
+    mutable NodePool<Node, &Node::index> nodes;
+    mutable std::vector<unsigned> buckets[bucketCount];
+    PositionMap data;
+    mutable unsigned last;
+    mutable unsigned long long nonEmpty; //Bit b is set if bucket b is not empty.
+    unsigned elementCount;
+
+    /**
+     * Returns the bucket for @key: 0 if it equals last, otherwise
+     * one more than the highest bit in which it differs from last.
+     */
+    unsigned bucketOf(unsigned key) const {
+        unsigned diff = key ^ last;
+        if(diff == 0) {
+            return 0;
+        }
+#if defined(__GNUC__)
+        return keyBits - __builtin_clz(diff);
+#else
+        unsigned bucket = 0;
+        for(; diff != 0; diff >>= 1) {
+            bucket++;
+        }
+        return bucket;
+#endif
+    }
+
+    /**
+     * Returns the node of the smallest element (the heap must not
+     * be empty), refilling bucket 0 first if needed.
+     */
+    unsigned minNode() const {
+        if(buckets[0].empty()) {
+            refill();
+        }
+        return buckets[0].back();
+    }
+
+    void attach(unsigned node, unsigned bucket) const {
+        nodes[node].bucket = bucket;
+        nodes[node].index = buckets[bucket].size();
+        buckets[bucket].push_back(node);
+        nonEmpty |= 1ull << bucket;
+    }
+
+    /**
+     * Takes @node out of its bucket by moving the last node of the
+     * bucket into its place.
+     */
+    void detach(unsigned node) const {
+        std::vector<unsigned>& bucket = buckets[nodes[node].bucket];
+        unsigned moved = bucket.back();
+        bucket[nodes[node].index] = moved;
+        nodes[moved].index = nodes[node].index;
+        bucket.pop_back();
+        if(bucket.empty()) {
+            nonEmpty &= ~(1ull << nodes[node].bucket);
+        }
+    }
+
+    /**
+     * Unlinks @node from the heap, removes its id from the
+     * position map and frees it.
+     */
+    void removeNode(unsigned node) {
+        data.remove(nodes[node].id);
+        detach(node);
+        nodes.release(node);
+        elementCount--;
+    }
+
+    /**
+     * Called when bucket 0 is empty but the heap is not: makes the
+     * smallest key in the first non-empty bucket the new last and
+     * redistributes that bucket. Every element of the bucket lands
+     * in a lower bucket, and at least one in bucket 0.
+     */
+    void refill() const {
+        unsigned source = lowestBit(nonEmpty);
+        std::vector<unsigned> moving;
+        moving.swap(buckets[source]);
+        nonEmpty &= ~(1ull << source);
+
+        last = nodes[moving[0]].key;
+        for(unsigned i = 1; i < moving.size(); i++) {
+            if(nodes[moving[i]].key < last) {
+                last = nodes[moving[i]].key;
+            }
+        }
+
+        for(unsigned i = 0; i < moving.size(); i++) {
+            attach(moving[i], bucketOf(nodes[moving[i]].key));
+        }
+
+        moving.clear();
+        moving.swap(buckets[source]); //Keep the bucket's capacity.
+    }
+};
+
+#endif  // RADIX_HEAP_HPP
@@ -0,0 +1,164 @@
+#ifndef RING_BUFFER_HPP
+#define RING_BUFFER_HPP
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * Bounded lock-free ring buffers for handing elements from
+ * producer threads to a single consumer thread.
+ *
+ * SpscRing is for exactly one producer: both ends are a single
+ * atomic counter, so a push or pop is one load of the other
+ * thread's counter and one store of its own. MpscRing allows any
+ * number of producers: each cell carries a sequence number and
+ * producers claim cells with a CAS on the tail (after Vyukov's
+ * bounded queue); the single consumer needs no CAS.
+ *
+ * Both have a fixed capacity, rounded up to a power of 2, and
+ * push returns false when the ring is full rather than blocking.
+ */
+
+inline unsigned ringCapacity(unsigned capacity)
+{
+    if(capacity == 0 || capacity > (1u << 31)) {
+        throw std::runtime_error("capacity must be in [1, 2^31]!");
+    }
+    unsigned rounded = 1;
+    while(rounded < capacity) {
+        rounded *= 2;
+    }
+    return rounded;
+}
+
+template <typename T>
+class SpscRing
+{
+public:
+    /**
+     * Creates a ring that holds at least @capacity elements.
+     */
+    explicit SpscRing(unsigned capacity) : cells(ringCapacity(capacity)), mask(cells.size()-1), head(0), tail(0) {};
+
+    unsigned capacity() const {
+        return cells.size();
+    };
+
+    /**
+     * Producer side: appends @value.
+     *
+     * Returns true if success.
+     * Returns false if the ring is full.
+     */
+    bool push(const T& value) {
+        unsigned t = tail.load(std::memory_order_relaxed);
+        if(t - head.load(std::memory_order_acquire) == cells.size()) {
+            return false;
+        }
+        cells[t & mask] = value;
+        tail.store(t+1, std::memory_order_release);
+        return true;
+    };
+
+    /**
+     * Consumer side: moves out every element that is in the ring
+     * and passes each of them to @sink.
+     *
+     * Returns the number of elements taken.
+     */
+    template <typename Sink>
+    unsigned popAll(Sink sink) {
+        unsigned h = head.load(std::memory_order_relaxed);
+        unsigned t = tail.load(std::memory_order_acquire);
+        for(unsigned i = h; i != t; i++) {
+            sink(std::move(cells[i & mask]));
+        }
+        head.store(t, std::memory_order_release);
+        return t - h;
+    };
+
+private:
+    std::vector<T> cells;
+    unsigned mask;
+    alignas(64) std::atomic<unsigned> head; //Next cell to pop, written by the consumer.
+    alignas(64) std::atomic<unsigned> tail; //Next cell to push, written by the producer.
+};
+
+template <typename T>
+class MpscRing
+{
+public:
+    /**
+     * Creates a ring that holds at least @capacity elements.
+     */
+    explicit MpscRing(unsigned capacity) : cells(ringCapacity(capacity)), mask(cells.size()-1), head(0), tail(0) {
+        for(unsigned i = 0; i < cells.size(); i++) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    };
+
+    unsigned capacity() const {
+        return cells.size();
+    };
+
+    /**
+     * Producer side, any thread: appends @value.
+     *
+     * Returns true if success.
+     * Returns false if the ring is full.
+     */
+    bool push(const T& value) {
+        unsigned t = tail.load(std::memory_order_relaxed);
+        while(true) {
+            Cell& cell = cells[t & mask];
+            unsigned sequence = cell.sequence.load(std::memory_order_acquire);
+            int difference = static_cast<int>(sequence - t);
+            if(difference == 0) { //Free for this lap: try to claim it.
+                if(tail.compare_exchange_weak(t, t+1, std::memory_order_relaxed)) {
+                    cell.value = value;
+                    cell.sequence.store(t+1, std::memory_order_release);
+                    return true;
+                }
+            } else if(difference < 0) { //Still holds the previous lap's element.
+                return false;
+            } else {
+                t = tail.load(std::memory_order_relaxed);
+            }
+        }
+    };
+
+    /**
+     * Consumer side: moves out the elements at the front of the ring
+     * that are completely written and passes each of them to @sink.
+     *
+     * Returns the number of elements taken.
+     */
+    template <typename Sink>
+    unsigned popAll(Sink sink) {
+        unsigned count = 0;
+        while(true) {
+            Cell& cell = cells[head & mask];
+            if(cell.sequence.load(std::memory_order_acquire) != head+1) { //Empty, or claimed but not written yet.
+                return count;
+            }
+            sink(std::move(cell.value));
+            cell.sequence.store(head + cells.size(), std::memory_order_release);
+            head++;
+            count++;
+        }
+    };
+
+private:
+    struct Cell {
+        std::atomic<unsigned> sequence;
+        T value;
+    };
+
+    std::vector<Cell> cells;
+    unsigned mask;
+    unsigned head; //Only used by the consumer.
+    alignas(64) std::atomic<unsigned> tail;
+};
+
+#endif  // RING_BUFFER_HPP
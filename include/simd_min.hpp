@@ -0,0 +1,119 @@
+#ifndef SIMD_MIN_HPP
+#define SIMD_MIN_HPP
+
+/**
+ * Helpers for finding the position of the smallest of a
+ * contiguous block of unsigned keys, used by PriorityQueue
+ * to pick the smallest child of a node in a d-ary heap.
+ *
+ * On x86 with GCC/Clang, blocks whose length is a multiple of
+ * 8 (AVX2) or 4 (SSE4.1) are compared with vector min
+ * instructions. The instruction set is chosen at runtime from
+ * the CPU features, so the binary does not need to be built
+ * with -mavx2. Everything else, and every other platform, uses
+ * the scalar loop. Define PRIORITY_QUEUE_NO_SIMD to always use
+ * the scalar loop.
+ *
+ * Ties are resolved the same way in every path: the first
+ * smallest key wins.
+ */
+
+#if !defined(PRIORITY_QUEUE_NO_SIMD) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define PRIORITY_QUEUE_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+/**
+ * Returns the offset of the smallest of the @count keys
+ * starting at @keys. @count must be at least 1.
+ */
+inline unsigned minIndexScalar(const unsigned* keys, unsigned count)
+{
+    unsigned smallest = 0;
+    for(unsigned i = 1; i < count; i++) {
+        if(keys[i] < keys[smallest]) {
+            smallest = i;
+        }
+    }
+    return smallest;
+}
+
+#ifdef PRIORITY_QUEUE_SIMD_X86
+
+// __builtin_cpu_init() is needed because these may be initialized
+// before the runtime's own CPU detection has run.
+inline const bool cpuHasSse41 = (__builtin_cpu_init(), __builtin_cpu_supports("sse4.1"));
+inline const bool cpuHasAvx2 = (__builtin_cpu_init(), __builtin_cpu_supports("avx2"));
+
+/**
+ * @count must be a multiple of 4.
+ */
+__attribute__((target("sse4.1")))
+inline unsigned minIndexSse41(const unsigned* keys, unsigned count)
+{
+    __m128i best = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys));
+    for(unsigned i = 4; i < count; i += 4) {
+        best = _mm_min_epu32(best, _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys+i)));
+    }
+
+    // Broadcast the minimum to every lane.
+    best = _mm_min_epu32(best, _mm_shuffle_epi32(best, _MM_SHUFFLE(1, 0, 3, 2)));
+    best = _mm_min_epu32(best, _mm_shuffle_epi32(best, _MM_SHUFFLE(2, 3, 0, 1)));
+
+    for(unsigned i = 0; i < count; i += 4) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys+i));
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(block, best)));
+        if(mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    return 0;
+}
+
+/**
+ * @count must be a multiple of 8.
+ */
+__attribute__((target("avx2")))
+inline unsigned minIndexAvx2(const unsigned* keys, unsigned count)
+{
+    __m256i best = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys));
+    for(unsigned i = 8; i < count; i += 8) {
+        best = _mm256_min_epu32(best, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys+i)));
+    }
+
+    // Broadcast the minimum to every lane.
+    best = _mm256_min_epu32(best, _mm256_permute2x128_si256(best, best, 1));
+    best = _mm256_min_epu32(best, _mm256_shuffle_epi32(best, _MM_SHUFFLE(1, 0, 3, 2)));
+    best = _mm256_min_epu32(best, _mm256_shuffle_epi32(best, _MM_SHUFFLE(2, 3, 0, 1)));
+
+    for(unsigned i = 0; i < count; i += 8) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys+i));
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(block, best)));
+        if(mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    return 0;
+}
+
+#endif  // PRIORITY_QUEUE_SIMD_X86
+
+/**
+ * Returns the offset of the smallest of the @count keys
+ * starting at @keys, using the widest vector path that the
+ * CPU supports for @count. @count must be at least 1.
+ */
+inline unsigned minIndex(const unsigned* keys, unsigned count)
+{
+#ifdef PRIORITY_QUEUE_SIMD_X86
+    if(count % 8 == 0 && cpuHasAvx2) {
+        return minIndexAvx2(keys, count);
+    }
+    if(count % 4 == 0 && cpuHasSse41) {
+        return minIndexSse41(keys, count);
+    }
+#endif
+    return minIndexScalar(keys, count);
+}
+
+#endif  // SIMD_MIN_HPP
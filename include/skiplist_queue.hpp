@@ -0,0 +1,375 @@
+#ifndef SKIPLIST_QUEUE_HPP
+#define SKIPLIST_QUEUE_HPP
+
+#include "priority_queue.hpp"
+#include "thread_random.hpp"
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * Implementation of a lock-free concurrent priority queue on top
+ * of a skiplist, after Lindén and Jonsson ("A Skiplist-Based
+ * Concurrent Priority Queue with Minimal Memory Contention", 2013).
+ * Unlike MultiQueue, the order is strict: deleteMin always removes
+ * the element with the smallest key among those in the queue when
+ * it takes effect.
+ *
+ * Elements are kept sorted by key in a skiplist. deleteMin does
+ * not unlink the node it removes: it marks the lowest-level pointer
+ * to it (a fetch-or of the low bit), so the deleted nodes form a
+ * prefix of the list, and a deleteMin walks that prefix to the
+ * first unmarked pointer. Only when the prefix is longer than
+ * boundOffset does the thread that notices swing the head pointer
+ * past it with a single CAS, and then unlink the prefix from the
+ * upper levels. Most deleteMins therefore do one atomic write to a
+ * node rather than contending on the head.
+ *
+ * Nodes cut off the list are freed with epoch-based reclamation:
+ * every operation registers in the current epoch, and a batch of
+ * unlinked nodes is only freed once no operation from the epoch in
+ * which it was unlinked (or an earlier one) is still running.
+ *
+ * The id of an element is carried along but not checked for
+ * uniqueness. All member functions are safe to call from several
+ * threads at once.
+ */
+template <typename ValueType>
+class SkipListQueue
+{
+public:
+    /**
+     * Creates an empty queue.
+     */
+    SkipListQueue() : head(new Node(0, 0, ValueType(), maxLevel)), tail(new Node(0, 0, ValueType(), maxLevel)), elementCount(0), epoch(0) {
+        for(unsigned i = 0; i < maxLevel; i++) {
+            head->next[i].store(toBits(tail));
+            tail->next[i].store(0);
+        }
+        head->inserting.store(false);
+        tail->inserting.store(false);
+    };
+
+    SkipListQueue(const SkipListQueue& rhs) = delete;
+    SkipListQueue& operator=(const SkipListQueue& rhs) = delete;
+
+    /**
+     * Must not run concurrently with any other member function.
+     */
+    ~SkipListQueue() {
+        Node* node = head;
+        while(node != nullptr) { //Deleted prefix, live nodes and tail.
+            Node* next = toNode(node->next[0].load());
+            delete node;
+            node = next;
+        }
+        for(unsigned e = 0; e < 3; e++) {
+            freeRetired(epochs[e].retired.exchange(nullptr));
+        }
+    };
+
+    /**
+     * Returns the number of elements. It is exact when no other
+     * thread is modifying the queue.
+     */
+    unsigned numElements() const {
+        return elementCount.load(std::memory_order_relaxed);
+    };
+
+    /**
+     * Inserts an element with identity @id and priority @key
+     * holding @value into the queue.
+     *
+     * This function runs in O(log n) expected time.
+     */
+    void insert(unsigned id, unsigned key, const ValueType& value) {
+        Guard guard(*this);
+
+        Node* node = new Node(id, key, value, randomLevel());
+        Node* preds[maxLevel];
+        Node* succs[maxLevel];
+        Node* deleted;
+        while(true) { //Link the lowest level, which puts the node in the queue.
+            deleted = locatePreds(key, preds, succs);
+            node->next[0].store(toBits(succs[0]));
+            std::uintptr_t expected = toBits(succs[0]);
+            if(preds[0]->next[0].compare_exchange_strong(expected, toBits(node))) {
+                break;
+            }
+        }
+        elementCount.fetch_add(1, std::memory_order_relaxed);
+
+        for(unsigned i = 1; i < node->height; i++) { //Upper levels are only shortcuts.
+            while(true) {
+                node->next[i].store(toBits(succs[i]));
+                if(isMarked(node->next[0].load()) || isMarked(succs[i]->next[0].load()) || deleted == succs[i]) {
+                    node->inserting.store(false);
+                    return;
+                }
+
+                std::uintptr_t expected = toBits(succs[i]);
+                if(preds[i]->next[i].compare_exchange_strong(expected, toBits(node))) {
+                    break;
+                }
+                deleted = locatePreds(key, preds, succs);
+                if(succs[0] != node) {
+                    node->inserting.store(false);
+                    return;
+                }
+            }
+        }
+        node->inserting.store(false);
+    };
+
+    /**
+     * Inserts a key-value pair mapping @key to @value, using
+     * @key both as the priority and as the identity of the element.
+     */
+    void insert(unsigned key, const ValueType& value) {
+        insert(key, key, value);
+    };
+
+    /**
+     * Removes the smallest element and writes it to @out.
+     *
+     * This function runs in O(1) time plus the walk over the
+     * deleted prefix, which is kept under boundOffset nodes
+     * (amortized).
+     *
+     * Returns true if success.
+     * Returns false if queue is empty, i.e. nothing to delete.
+     */
+    bool deleteMin(Element<ValueType>& out) {
+        Guard guard(*this);
+
+        Node* x = head;
+        Node* newHead = nullptr;
+        unsigned offset = 0;
+        std::uintptr_t observedHead = head->next[0].load();
+        std::uintptr_t next;
+        do { //Mark the first unmarked lowest-level pointer.
+            next = x->next[0].load();
+            if(toNode(next) == tail) {
+                return false;
+            }
+            if(newHead == nullptr && x->inserting.load()) {
+                newHead = x;
+            }
+            next = x->next[0].fetch_or(1);
+            offset++;
+            x = toNode(next);
+        } while(isMarked(next));
+
+        out = Element<ValueType>{x->id, x->key, x->value};
+        elementCount.fetch_sub(1, std::memory_order_relaxed);
+        if(offset <= boundOffset) {
+            return true;
+        }
+
+        //Cut the deleted prefix off, up to x or the first node that
+        //is still being inserted.
+        if(newHead == nullptr) {
+            newHead = x;
+        }
+        if(head->next[0].compare_exchange_strong(observedHead, toBits(newHead) | 1)) {
+            restructure();
+            Node* first = toNode(observedHead);
+            if(first != newHead) {
+                retire(first, newHead);
+            }
+        }
+        return true;
+    };
+
+    /**
+     * Finds an element with priority @key and writes it to @out.
+     *
+     * This function runs in O(log n) expected time.
+     *
+     * Returns true if success.
+     * Returns false if no element has priority @key.
+     */
+    bool find(unsigned key, Element<ValueType>& out) const {
+        Guard guard(*this);
+
+        Node* preds[maxLevel];
+        Node* succs[maxLevel];
+        locatePreds(key, preds, succs);
+        Node* node = succs[0];
+        if(node == tail || node->key != key) {
+            return false;
+        }
+        out = Element<ValueType>{node->id, node->key, node->value};
+        return true;
+    };
+
+private:
+    struct Node {
+        Node(unsigned id, unsigned key, const ValueType& value, unsigned height)
+            : id(id), key(key), value(value), height(height), next(new std::atomic<std::uintptr_t>[height]), inserting(true) {};
+
+        ~Node() {
+            delete[] next;
+        };
+
+        unsigned id;
+        unsigned key;
+        ValueType value;
+        unsigned height;
+        std::atomic<std::uintptr_t>* next; //Low bit of next[0] set: the next node is deleted.
+        std::atomic<bool> inserting;
+        Node* retiredNext; //Next retired batch.
+        Node* retiredEnd; //One past the last node of this retired batch.
+    };
+
+    /**
+     * Registers the running operation in the current epoch for
+     * as long as it lives.
+     */
+    class Guard {
+    public:
+        explicit Guard(const SkipListQueue& queue) : queue(queue) {
+            while(true) {
+                e = queue.epoch.load();
+                queue.epochs[e%3].active.fetch_add(1);
+                if(queue.epoch.load() == e) {
+                    return;
+                }
+                queue.epochs[e%3].active.fetch_sub(1);
+            }
+        };
+
+        ~Guard() {
+            queue.epochs[e%3].active.fetch_sub(1);
+        };
+
+    private:
+        const SkipListQueue& queue;
+        unsigned long long e;
+    };
+
+    struct alignas(64) Epoch {
+        std::atomic<long> active{0}; //Operations running in this epoch.
+        std::atomic<Node*> retired{nullptr}; //Batches unlinked in this epoch.
+    };
+
+    static constexpr unsigned maxLevel = 24;
+    static constexpr unsigned boundOffset = 32;
+
+    Node* head;
+    Node* tail;
+    std::atomic<unsigned> elementCount;
+    mutable std::atomic<unsigned long long> epoch;
+    mutable Epoch epochs[3];
+
+    static std::uintptr_t toBits(Node* node) {
+        return reinterpret_cast<std::uintptr_t>(node);
+    }
+
+    static Node* toNode(std::uintptr_t bits) {
+        return reinterpret_cast<Node*>(bits & ~static_cast<std::uintptr_t>(1));
+    }
+
+    static bool isMarked(std::uintptr_t bits) {
+        return (bits & 1) != 0;
+    }
+
+    /**
+     * Returns a random height in [1, maxLevel], each level half as
+     * likely as the one below (see thread_random.hpp).
+     */
+    static unsigned randomLevel() {
+        unsigned level = 1;
+        for(unsigned long long bits = threadRandom(); (bits & 1) != 0 && level < maxLevel; bits >>= 1) {
+            level++;
+        }
+        return level;
+    }
+
+    /**
+     * Fills @preds and @succs with the nodes around where @key
+     * goes at each level, skipping deleted nodes at the lowest
+     * level. Returns the last deleted node passed at the lowest
+     * level, or null pointer.
+     */
+    Node* locatePreds(unsigned key, Node** preds, Node** succs) const {
+        Node* x = head;
+        Node* deleted = nullptr;
+        for(unsigned i = maxLevel; i-- > 0; ) {
+            std::uintptr_t bits = x->next[i].load();
+            Node* cur = toNode(bits);
+            bool marked = isMarked(bits);
+            while((cur != tail && cur->key < key) || isMarked(cur->next[0].load()) || (i == 0 && marked)) {
+                if(i == 0 && marked) {
+                    deleted = cur;
+                }
+                x = cur;
+                bits = x->next[i].load();
+                cur = toNode(bits);
+                marked = isMarked(bits);
+            }
+            preds[i] = x;
+            succs[i] = cur;
+        }
+        return deleted;
+    }
+
+    /**
+     * Moves the upper-level head pointers past the deleted prefix.
+     */
+    void restructure() {
+        Node* pred = head;
+        for(unsigned i = maxLevel-1; i > 0; ) {
+            std::uintptr_t first = head->next[i].load();
+            if(!isMarked(toNode(first)->next[0].load())) {
+                i--;
+                continue;
+            }
+
+            Node* cur = toNode(pred->next[i].load());
+            while(isMarked(cur->next[0].load())) {
+                pred = cur;
+                cur = toNode(pred->next[i].load());
+            }
+            if(head->next[i].compare_exchange_strong(first, pred->next[i].load())) {
+                i--;
+            }
+        }
+    }
+
+    /**
+     * Hands the nodes from @first up to (not including) @end, which
+     * are no longer reachable from the head, to the current epoch,
+     * and tries to free older batches.
+     */
+    void retire(Node* first, Node* end) {
+        first->retiredEnd = end;
+        Epoch& current = epochs[epoch.load()%3];
+        Node* top = current.retired.load();
+        do {
+            first->retiredNext = top;
+        } while(!current.retired.compare_exchange_weak(top, first));
+
+        //Moving from epoch e to e+1 needs every operation of epoch e-1
+        //to be done; the batches retired in e-1 can then be freed.
+        unsigned long long e = epoch.load();
+        if(epochs[(e+2)%3].active.load() == 0 && epoch.compare_exchange_strong(e, e+1)) {
+            freeRetired(epochs[(e+2)%3].retired.exchange(nullptr));
+        }
+    }
+
+    void freeRetired(Node* batch) {
+        while(batch != nullptr) {
+            Node* nextBatch = batch->retiredNext;
+            Node* end = batch->retiredEnd;
+            for(Node* node = batch; node != end; ) {
+                Node* next = toNode(node->next[0].load());
+                delete node;
+                node = next;
+            }
+            batch = nextBatch;
+        }
+    }
+};
+
+#endif  // SKIPLIST_QUEUE_HPP
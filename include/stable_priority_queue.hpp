@@ -0,0 +1,246 @@
+#ifndef STABLE_PRIORITY_QUEUE_HPP
+#define STABLE_PRIORITY_QUEUE_HPP
+
+#include "priority_queue.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+/**
+ * A PriorityQueue in which elements with the same priority come
+ * out in the order they were inserted (first in, first out).
+ *
+ * The underlying queue is keyed on unsigned long long: the high 32
+ * bits hold the priority and the low 32 bits an insertion sequence
+ * number, so ties are broken by a single 64-bit comparison rather
+ * than a second compare or a comparator with a branch in it.
+ * decreaseKey and increaseKey change the high half only, so an
+ * element keeps its place among the elements of its new priority
+ * that were inserted before and after it.
+ *
+ * The sequence number is 32 bits wide. When it runs out (after
+ * 2^32 inserts), the elements are renumbered 0 to n-1 in the
+ * order they were inserted and the queue is rebuilt, in O(n log n)
+ * time once every 2^32 inserts. Insertion order is kept rather
+ * than output order, since elements of different priorities may
+ * tie later on after a decreaseKey or increaseKey.
+ *
+ * Keys are packed per element, so the queue takes 4 more bytes per
+ * heap entry than a PriorityQueue, and the SIMD child search of
+ * PriorityQueue does not apply.
+ */
+template <typename ValueType, typename PositionMap = HashTable<unsigned>, unsigned Arity = 2>
+class StablePriorityQueue
+{
+public:
+    /**
+     * Creates a stable priority queue that can have at most @maxSize
+     * elements.
+     *
+     * Throws std::runtime_error if @maxSize is 0.
+     */
+    explicit StablePriorityQueue(unsigned maxSize) : queue(maxSize), nextSequence(0) {};
+
+    /**
+     * Creates a growable stable priority queue.
+     */
+    StablePriorityQueue() : nextSequence(0) {};
+
+    /**
+     * Both of these must run in constant time.
+     */
+    unsigned numElements() const {
+        return queue.numElements();
+    };
+
+    unsigned maxSize() const {
+        return queue.maxSize();
+    };
+
+    /**
+     * Inserts an element with identity @id and priority @key
+     * holding @value into the priority queue, after every element
+     * that has the same priority.
+     *
+     * Returns true if success.
+     * Returns false if @id is already in the priority queue
+     * or if max size would be exceeded on a fixed-size queue.
+     * (In either of these cases, the insertion is not performed.)
+     */
+    bool insert(unsigned id, unsigned key, const ValueType& value) {
+        if(nextSequence == ~0u) {
+            renumber();
+        }
+        if(!queue.insert(id, pack(key, nextSequence), value)) {
+            return false;
+        }
+        nextSequence++;
+        return true;
+    };
+
+    /**
+     * Inserts a key-value pair mapping @key to @value, using
+     * @key both as the priority and as the identity of the element.
+     */
+    bool insert(unsigned key, const ValueType& value) {
+        return insert(key, key, value);
+    };
+
+    /**
+     * Returns key, id or value of the smallest element in the
+     * priority queue or null pointer if empty. Among elements of
+     * equal priority, the smallest one is the oldest.
+     *
+     * These functions run in constant time.
+     *
+     * The pointer may be invalidated if the priority queue is
+     * modified, and the one from getMinKey() by the next call to
+     * getMinKey().
+     */
+    const unsigned* getMinKey() const {
+        const unsigned long long* packed = queue.getMinKey();
+        if(packed == nullptr) {
+            return nullptr;
+        }
+        minKey = unpack(*packed);
+        return &minKey;
+    };
+
+    const unsigned* getMinId() const {
+        return queue.getMinId();
+    };
+
+    const ValueType* getMinValue() const {
+        return queue.getMinValue();
+    };
+
+    /**
+     * Removes the root of the priority queue.
+     *
+     * This function runs in logarithmic time.
+     *
+     * Returns true if success.
+     * Returns false if priority queue is empty, i.e. nothing to delete.
+     */
+    bool deleteMin() {
+        return queue.deleteMin();
+    };
+
+    /**
+     * Removes the (at most) @k smallest elements, writing them in
+     * order to @out as Element<ValueType>s (values are moved out
+     * of the queue), as PriorityQueue::deleteMinBatch() does.
+     *
+     * Returns the number of elements removed.
+     */
+    template <typename OutputIt>
+    unsigned deleteMinBatch(unsigned k, OutputIt out) {
+        std::vector<Element<ValueType, unsigned long long>> batch;
+        queue.deleteMinBatch(k, std::back_inserter(batch));
+        for(unsigned i = 0; i < batch.size(); i++) {
+            *out = Element<ValueType>{batch[i].id, unpack(batch[i].key), std::move(batch[i].value)};
+            ++out;
+        }
+        return batch.size();
+    };
+
+    /**
+     * Returns address of the value of the element with identity @id,
+     * or null pointer if @id is not in the priority queue.
+     */
+    ValueType* get(unsigned id) {
+        return queue.get(id);
+    };
+
+    const ValueType* get(unsigned id) const {
+        return queue.get(id);
+    };
+
+    /**
+     * Returns address of the priority of the element with identity @id,
+     * or null pointer if @id is not in the priority queue.
+     *
+     * The pointer may be invalidated if the priority queue is
+     * modified, or by the next call to getKey().
+     */
+    const unsigned* getKey(unsigned id) const {
+        const unsigned long long* packed = queue.getKey(id);
+        if(packed == nullptr) {
+            return nullptr;
+        }
+        foundKey = unpack(*packed);
+        return &foundKey;
+    };
+
+    /**
+     * Subtracts/adds @change from/to the priority of
+     * the element that has identity @id. The element keeps its
+     * insertion sequence number.
+     *
+     * Returns true if success.
+     * Returns false if any of the following:
+     * - @change is 0.
+     * - @id not found.
+     *
+     * As in PriorityQueue, overflow/underflow has an undefined effect.
+     */
+    bool decreaseKey(unsigned id, unsigned change) {
+        return queue.decreaseKey(id, static_cast<unsigned long long>(change) << 32);
+    };
+
+    bool increaseKey(unsigned id, unsigned change) {
+        return queue.increaseKey(id, static_cast<unsigned long long>(change) << 32);
+    };
+
+    /**
+     * Removes element that has identity @id.
+     *
+     * Returns true if success.
+     * Returns false if @id not found.
+     */
+    bool remove(unsigned id) {
+        return queue.remove(id);
+    };
+
+private:
+    PriorityQueue<ValueType, PositionMap, Arity, unsigned long long> queue;
+    unsigned nextSequence;
+    mutable unsigned minKey; //Returned by getMinKey().
+    mutable unsigned foundKey; //Returned by getKey().
+
+    static unsigned long long pack(unsigned key, unsigned sequence) {
+        return (static_cast<unsigned long long>(key) << 32) | sequence;
+    }
+
+    static unsigned unpack(unsigned long long packed) {
+        return packed >> 32;
+    }
+
+    static unsigned sequence(unsigned long long packed) {
+        return static_cast<unsigned>(packed);
+    }
+
+    /**
+     * Gives the elements the sequence numbers 0 to n-1 in the order
+     * they were inserted, and rebuilds the queue from them.
+     *
+     * This function runs in O(n log n) time.
+     */
+    void renumber() {
+        std::vector<Element<ValueType, unsigned long long>> elements;
+        elements.reserve(queue.numElements());
+        queue.deleteMinBatch(queue.numElements(), std::back_inserter(elements));
+        std::sort(elements.begin(), elements.end(), [](const Element<ValueType, unsigned long long>& a, const Element<ValueType, unsigned long long>& b) {
+            return sequence(a.key) < sequence(b.key);
+        });
+        for(unsigned i = 0; i < elements.size(); i++) {
+            elements[i].key = pack(unpack(elements[i].key), i);
+        }
+        queue.assign(elements.begin(), elements.end());
+        nextSequence = elements.size();
+    }
+};
+
+#endif  // STABLE_PRIORITY_QUEUE_HPP
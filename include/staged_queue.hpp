@@ -0,0 +1,150 @@
+#ifndef STAGED_QUEUE_HPP
+#define STAGED_QUEUE_HPP
+
+#include "priority_queue.hpp"
+#include "ring_buffer.hpp"
+
+#include <memory>
+#include <vector>
+
+/**
+ * A PriorityQueue owned by one consumer thread that other threads
+ * can insert into without taking a lock.
+ *
+ * Producers do not touch the heap: they push elements into
+ * bounded lock-free ring buffers (see ring_buffer.hpp). Each of
+ * the first @producers threads can be given its own SpscRing,
+ * which is the cheapest to push into; any other thread pushes into
+ * a shared MpscRing. The consumer moves everything that is staged
+ * into the heap with a single insertBatch() before each getMin or
+ * deleteMin, so the heap is only ever touched by one thread, and
+ * the repair work is shared by the whole batch.
+ *
+ * Every member function except the push functions must be called
+ * from the consumer thread. Elements that a producer is still
+ * pushing while the consumer drains are picked up by the next
+ * drain.
+ */
+template <typename ValueType, typename PositionMap = HashTable<unsigned>>
+class StagedQueue
+{
+public:
+    /**
+     * Creates a queue with @producers dedicated SPSC rings and one
+     * shared MPSC ring, each holding at least @capacity elements.
+     */
+    explicit StagedQueue(unsigned producers, unsigned capacity = 1024) : shared(capacity) {
+        for(unsigned i = 0; i < producers; i++) {
+            dedicated.emplace_back(new SpscRing<Element<ValueType>>(capacity));
+        }
+    };
+
+    StagedQueue(const StagedQueue& rhs) = delete;
+    StagedQueue& operator=(const StagedQueue& rhs) = delete;
+
+    unsigned numProducers() const {
+        return dedicated.size();
+    };
+
+    /**
+     * Producer side: stages an element with identity @id and
+     * priority @key holding @value in the ring of producer
+     * @producer. Only one thread may push as a given @producer.
+     *
+     * Returns true if success.
+     * Returns false if the ring is full (in which case, the
+     * element is not staged).
+     */
+    bool push(unsigned producer, unsigned id, unsigned key, const ValueType& value) {
+        return dedicated[producer]->push(Element<ValueType>{id, key, value});
+    };
+
+    /**
+     * Producer side, any thread: stages an element with identity
+     * @id and priority @key holding @value in the shared ring.
+     *
+     * Returns true if success.
+     * Returns false if the ring is full (in which case, the
+     * element is not staged).
+     */
+    bool push(unsigned id, unsigned key, const ValueType& value) {
+        return shared.push(Element<ValueType>{id, key, value});
+    };
+
+    /**
+     * Moves every staged element into the heap with one
+     * insertBatch(). Elements whose id is already in the heap are
+     * dropped, as in insertBatch().
+     *
+     * Returns the number of elements inserted.
+     */
+    unsigned drain() {
+        batch.clear();
+        auto sink = [this](Element<ValueType>&& element) { batch.push_back(std::move(element)); };
+        for(unsigned i = 0; i < dedicated.size(); i++) {
+            dedicated[i]->popAll(sink);
+        }
+        shared.popAll(sink);
+        if(batch.empty()) {
+            return 0;
+        }
+        return queue.insertBatch(batch.begin(), batch.end());
+    };
+
+    /**
+     * Returns the number of elements in the heap, i.e. not
+     * counting those that are still staged.
+     */
+    unsigned numElements() const {
+        return queue.numElements();
+    };
+
+    /**
+     * Drains the rings, then returns key, id or value of the
+     * smallest element, or null pointer if empty.
+     *
+     * The pointer may be invalidated if the queue is modified.
+     */
+    const unsigned* getMinKey() {
+        drain();
+        return queue.getMinKey();
+    };
+
+    const unsigned* getMinId() {
+        drain();
+        return queue.getMinId();
+    };
+
+    const ValueType* getMinValue() {
+        drain();
+        return queue.getMinValue();
+    };
+
+    /**
+     * Drains the rings, then removes the smallest element and
+     * writes it to @out.
+     *
+     * Returns true if success.
+     * Returns false if queue is empty, i.e. nothing to delete.
+     */
+    bool deleteMin(Element<ValueType>& out) {
+        drain();
+        return queue.deleteMinBatch(1, &out) == 1;
+    };
+
+    /**
+     * Returns the heap itself, for the rest of the extended API.
+     * Staged elements are not in it until the next drain().
+     */
+    PriorityQueue<ValueType, PositionMap>& heap() {
+        return queue;
+    };
+
+private:
+    PriorityQueue<ValueType, PositionMap> queue;
+    std::vector<std::unique_ptr<SpscRing<Element<ValueType>>>> dedicated;
+    MpscRing<Element<ValueType>> shared;
+    std::vector<Element<ValueType>> batch; //Reused by drain().
+};
+
+#endif  // STAGED_QUEUE_HPP
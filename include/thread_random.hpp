@@ -0,0 +1,26 @@
+#ifndef THREAD_RANDOM_HPP
+#define THREAD_RANDOM_HPP
+
+#include <functional>
+#include <thread>
+
+/**
+ * Returns the next number of a xorshift generator that each
+ * thread has its own copy of, seeded from the thread's id.
+ *
+ * This is for the random choices of the concurrent queues (which
+ * shard to use, how tall a skiplist node is, which worker to
+ * steal from): it is a few instructions, takes no lock and
+ * shares no state between threads. It is not meant for anything
+ * that needs good random numbers.
+ */
+inline unsigned long long threadRandom()
+{
+    thread_local unsigned long long state = std::hash<std::thread::id>()(std::this_thread::get_id()) | 1;
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+#endif  // THREAD_RANDOM_HPP
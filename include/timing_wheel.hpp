@@ -0,0 +1,343 @@
+#ifndef TIMING_WHEEL_HPP
+#define TIMING_WHEEL_HPP
+
+#include "priority_queue.hpp"
+#include "node_pool.hpp"
+
+#include <vector>
+
+/**
+ * Implementation of a hierarchical timing wheel: a timer queue
+ * keyed by an unsigned deadline, meant to replace a
+ * PriorityQueue of timers when most of them are cancelled before
+ * they expire (network timeouts, retries, ...).
+ *
+ * The wheel keeps a current time and six levels of 64 slots.
+ * A timer is placed by the highest base-64 digit in which its
+ * deadline differs from the current time: that digit selects the
+ * level, and the deadline's digit at that level selects the slot.
+ * So level 0 holds the timers due in the next 64 ticks, level 1
+ * those due within the next 64^2 ticks, and so on. Each slot is an
+ * intrusive, circular doubly linked list of pool nodes, and each
+ * level has a bitmap of its non-empty slots.
+ *
+ * insert and remove (cancel) are O(1) and never compare deadlines.
+ * advance(now, out) jumps from one non-empty slot to the next with
+ * the bitmaps, so it does not step through idle ticks. When it
+ * reaches a slot above level 0 it moves the slot's timers down
+ * (each timer moves down at most once per level), and level 0
+ * slots are expired as a batch.
+ *
+ * A cancel looks the timer's id up in the position map and
+ * unlinks its node from the slot list, so it never touches the
+ * other timers or the bitmaps of other slots.
+ */
+template <typename ValueType, typename PositionMap = HashTable<unsigned>>
+class TimingWheel
+{
+public:
+    /**
+     * Creates an empty timing wheel whose current time is @now.
+     */
+    explicit TimingWheel(unsigned now = 0) : heads(levelCount*slotCount, none), data(initialMapSize), current(now), elementCount(0) {
+        for(unsigned l = 0; l < levelCount; l++) {
+            occupied[l] = 0;
+        }
+    };
+
+    /**
+     * Makes room for @capacity nodes, so that inserting up to
+     * that many timers does not reallocate the node pool.
+     */
+    void reserve(unsigned capacity) {
+        nodes.reserve(capacity);
+    };
+
+    /**
+     * Both of these must run in constant time.
+     */
+    unsigned numElements() const {
+        return elementCount;
+    };
+
+    unsigned currentTime() const {
+        return current;
+    };
+
+    /**
+     * Inserts a timer with identity @id that expires at @deadline
+     * and holds @value.
+     *
+     * A deadline that is not after currentTime() is expired by the
+     * next call to advance().
+     *
+     * This function runs in constant time (amortized over the
+     * growth of the node pool).
+     *
+     * Returns true if success.
+     * Returns false if @id is already in the wheel
+     * (in which case, the insertion is not performed).
+     */
+    bool insert(unsigned id, unsigned deadline, const ValueType& value) {
+        unsigned node = nodes.allocate();
+        if(!data.insert(id, node)) {
+            nodes.release(node);
+            return false;
+        }
+
+        nodes[node].id = id;
+        nodes[node].deadline = deadline;
+        nodes[node].value = value;
+        link(node);
+        elementCount++;
+        return true;
+    };
+
+    /**
+     * Returns address of the value of the timer with identity @id.
+     *
+     * These functions run in "constant time".
+     *
+     * Returns null pointer if @id is not in the wheel.
+     *
+     * The pointer may be invalidated if an insert grows the node pool.
+     */
+    ValueType* get(unsigned id) {
+        const unsigned* node = data.get(id);
+        if(node == nullptr) {
+            return nullptr;
+        }
+        return &nodes[*node].value;
+    };
+
+    const ValueType* get(unsigned id) const {
+        const unsigned* node = data.get(id);
+        if(node == nullptr) {
+            return nullptr;
+        }
+        return &nodes[*node].value;
+    };
+
+    /**
+     * Returns address of the deadline of the timer with identity @id,
+     * or null pointer if @id is not in the wheel.
+     */
+    const unsigned* getKey(unsigned id) const {
+        const unsigned* node = data.get(id);
+        if(node == nullptr) {
+            return nullptr;
+        }
+        return &nodes[*node].deadline;
+    };
+
+    /**
+     * Cancels the timer that has identity @id.
+     *
+     * This function runs in constant time.
+     *
+     * Returns true if success.
+     * Returns false if @id not found.
+     */
+    bool remove(unsigned id) {
+        const unsigned* found = data.get(id);
+        if(found == nullptr) {
+            return false;
+        }
+
+        unsigned node = *found;
+        data.remove(id);
+        unlink(node);
+        nodes.release(node);
+        elementCount--;
+        return true;
+    };
+
+    /**
+     * Moves the current time forward to @now and expires every
+     * timer whose deadline is not after @now, writing them to
+     * @out as Element<ValueType>s (with the deadline as key) in
+     * order of deadline; timers that were inserted already overdue
+     * come first. @now earlier than currentTime() only expires the
+     * timers that are already due.
+     *
+     * This function runs in time proportional to the number of
+     * timers expired or moved down a level, plus the number of
+     * non-empty slots visited.
+     *
+     * Returns the number of timers expired.
+     */
+    template <typename OutputIt>
+    unsigned advance(unsigned now, OutputIt out) {
+        unsigned expired = expire(out);
+        while(now > current) {
+            unsigned level = 0;
+            unsigned next = 0;
+            for(; level < levelCount; level++) { //The lowest level with a later slot has the earliest one.
+                unsigned digit = slotOf(current, level);
+                unsigned long long later = (digit == slotCount-1) ? 0 : occupied[level] >> (digit+1) << (digit+1);
+                if(later != 0) {
+                    next = startOf(level, lowestBit(later));
+                    break;
+                }
+            }
+
+            if(level == levelCount || next > now) { //Nothing to do before @now.
+                current = now;
+                break;
+            }
+
+            current = next;
+            if(level > 0) {
+                cascade(level, slotOf(current, level));
+            }
+            expired += expire(out);
+        }
+        return expired;
+    };
+
+private:
+    struct Node {
+        unsigned id;
+        unsigned deadline;
+        ValueType value;
+        unsigned slot; //Index in heads.
+        unsigned next; //Next node in the slot, or next free node.
+        unsigned prev;
+    };
+
+    static constexpr unsigned none = ~0u;
+    static constexpr unsigned initialMapSize = 11;
+    static constexpr unsigned slotBits = 6;
+    static constexpr unsigned slotCount = 1u << slotBits;
+    static constexpr unsigned levelCount = (8*sizeof(unsigned) + slotBits-1) / slotBits;
+
+    NodePool<Node, &Node::next> nodes;
+    std::vector<unsigned> heads; //First node of each slot, level by level.
+    unsigned long long occupied[levelCount]; //Bit s of occupied[l] is set if slot s of level l is not empty.
+    PositionMap data;
+    unsigned current;
+    unsigned elementCount;
+
+    static unsigned highestBit(unsigned value) {
+#if defined(__GNUC__)
+        return 8*sizeof(unsigned)-1 - __builtin_clz(value);
+#else
+        unsigned bit = 0;
+        for(; value > 1; value >>= 1) {
+            bit++;
+        }
+        return bit;
+#endif
+    }
+
+    static unsigned slotOf(unsigned time, unsigned level) {
+        return (time >> (slotBits*level)) & (slotCount-1);
+    }
+
+    /**
+     * Returns the first tick of slot @slot of @level, i.e. current
+     * with its digit at @level replaced by @slot and the lower
+     * digits cleared.
+     */
+    unsigned startOf(unsigned level, unsigned slot) const {
+        unsigned shift = slotBits*level;
+        unsigned long long upper = (static_cast<unsigned long long>(current) >> (shift+slotBits)) << (shift+slotBits);
+        return upper | (slot << shift);
+    }
+
+    /**
+     * Adds @node to the back of the slot of its deadline. Overdue
+     * nodes go to the current slot of level 0.
+     */
+    void link(unsigned node) {
+        unsigned deadline = nodes[node].deadline;
+        unsigned level = 0;
+        unsigned slot = slotOf(current, 0);
+        if(deadline > current) {
+            level = highestBit(deadline ^ current) / slotBits;
+            slot = slotOf(deadline, level);
+        }
+
+        nodes[node].slot = level*slotCount + slot;
+        unsigned& head = heads[level*slotCount + slot];
+        if(head == none) {
+            head = node;
+            nodes[node].next = node;
+            nodes[node].prev = node;
+            occupied[level] |= 1ull << slot;
+        } else {
+            unsigned tail = nodes[head].prev;
+            nodes[node].next = head;
+            nodes[node].prev = tail;
+            nodes[tail].next = node;
+            nodes[head].prev = node;
+        }
+    }
+
+    void unlink(unsigned node) {
+        unsigned slot = nodes[node].slot;
+        unsigned& head = heads[slot];
+        if(nodes[node].next == node) { //Only node in the slot.
+            head = none;
+            occupied[slot/slotCount] &= ~(1ull << (slot%slotCount));
+            return;
+        }
+
+        unsigned next = nodes[node].next;
+        unsigned prev = nodes[node].prev;
+        nodes[prev].next = next;
+        nodes[next].prev = prev;
+        if(head == node) {
+            head = next;
+        }
+    }
+
+    /**
+     * Takes the whole list of slot @slot of @level out of the wheel
+     * and returns its first node (or none).
+     */
+    unsigned takeSlot(unsigned level, unsigned slot) {
+        unsigned first = heads[level*slotCount + slot];
+        heads[level*slotCount + slot] = none;
+        occupied[level] &= ~(1ull << slot);
+        if(first != none) {
+            nodes[nodes[first].prev].next = none; //Break the circle.
+        }
+        return first;
+    }
+
+    /**
+     * Re-links the timers of slot @slot of @level relative to the
+     * current time, which moves each of them to a lower level.
+     */
+    void cascade(unsigned level, unsigned slot) {
+        unsigned node = takeSlot(level, slot);
+        while(node != none) {
+            unsigned next = nodes[node].next;
+            link(node);
+            node = next;
+        }
+    }
+
+    /**
+     * Expires the timers in the current slot of level 0.
+     */
+    template <typename OutputIt>
+    unsigned expire(OutputIt& out) {
+        unsigned count = 0;
+        unsigned node = takeSlot(0, slotOf(current, 0));
+        while(node != none) {
+            unsigned next = nodes[node].next;
+            *out = Element<ValueType>{nodes[node].id, nodes[node].deadline, std::move(nodes[node].value)};
+            ++out;
+            data.remove(nodes[node].id);
+            nodes.release(node);
+            elementCount--;
+            count++;
+            node = next;
+        }
+        return count;
+    }
+};
+
+#endif  // TIMING_WHEEL_HPP